@@ -0,0 +1,48 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Player;
+
+// Scripted flythrough started with --benchmark. The player flies a fixed path over a fresh save with a fixed seed,
+// so every run streams in the same chunks, and frame times, chunk load latency, streaming throughput and peak
+// memory are written to a JSON report when the path ends
+class Benchmark {
+public:
+    static constexpr uint32_t SEED = 453235343;
+    static constexpr const char* SAVE_NAME = "benchmark";
+
+    explicit Benchmark(const std::string& reportPath);
+
+    // Starts the clock and the chunk metrics, called once the world is running
+    void begin(Player& player);
+    // Places the player on the path for this frame, returns false once the path is done
+    bool update(Player& player, float deltaTime);
+    void recordFrame(float deltaTime, size_t chunkMeshBytes);
+
+    bool writeReport() const;
+
+private:
+    std::string reportPath;
+    std::string renderer;
+
+    float pathTime = 0.0f;
+    double startTime = 0.0;
+    double endTime = 0.0;
+    std::vector<float> frameMilliseconds;
+    size_t peakChunkMeshBytes = 0;
+
+    uint64_t startChunksLoaded = 0;
+    uint64_t startMeshes = 0;
+    uint64_t startUploadedBytes = 0;
+
+    static void placeOnPath(Player& player, float time);
+    static uint64_t peakProcessMemory();
+
+};
+
+#endif
@@ -4,17 +4,34 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <filesystem>
 
 #include "core/player/Player.h"
+#include "core/game/Benchmark.h"
+#include "core/game/QualityController.h"
 #include "core/registers/BlockRegister.h"
 #include "graphics/Shader.h"
 #include "graphics/Texture.h"
+#include "graphics/BufferTexture.h"
+#include "graphics/ChunkBufferArena.h"
+#include "graphics/FrameUniforms.h"
+#include "graphics/FrameProfiler.h"
+#include "graphics/RenderTarget.h"
+#include "core/world/ChunkCuller.h"
+#include "core/world/ChunkOcclusionQueries.h"
 
 class World;
 
+// How chunk meshes are drawn. VERTEX_PULLING uploads one 32 bit record per face and expands it into a quad
+// in shaders/block_pulling.vert, chunks without records still draw from their vertex buffers
+enum class ChunkRenderMode {
+    VERTEX_BUFFERS,
+    VERTEX_PULLING
+};
+
 class Game {
 public:
     Game(GLFWwindow* windowptr, bool devMode = true);
@@ -32,6 +49,7 @@ public:
     std::string getSavePath() const;
 
     void init();
+    void simulate(float frameSeconds);
     void tick();
     void render();
     void shutdown();
@@ -47,6 +65,57 @@ public:
     void setEnableFog(bool enable) { enableFog = enable; }
     bool isFogEnabled() const { return enableFog; }
 
+    // Chunk distance from which chunks are meshed at the given level of detail, 0 disables that level
+    void setLodDistance(int lodLevel, int distance) { lodDistances[lodLevel - 1] = distance; }
+    int getLodDistance(int lodLevel) const { return lodDistances[lodLevel - 1]; }
+    int getLodLevelForDistance(int chunkDistance) const;
+
+    void setChunkRenderMode(ChunkRenderMode mode) { chunkRenderMode = mode; }
+    ChunkRenderMode getChunkRenderMode() const { return chunkRenderMode; }
+    // Switches between the two chunk renderers and remeshes the loaded chunks for the new one
+    void toggleChunkRenderMode();
+
+    // Skips chunks hidden behind terrain, see ChunkCuller
+    void setOcclusionCulling(bool enable) { chunkCuller.setOcclusionCulling(enable); }
+    bool isOcclusionCulling() const { return chunkCuller.isOcclusionCulling(); }
+
+    // Skips chunks whose bounding boxes were hidden last frame, see ChunkOcclusionQueries
+    void setOcclusionQueries(bool enable) { occlusionQueries = enable; }
+    bool isUsingOcclusionQueries() const { return occlusionQueries; }
+
+    // Vertex buffer chunks are drawn with one multi-draw per arena page instead of one draw per chunk
+    void setBatchChunkDraws(bool batch) { batchChunkDraws = batch; }
+    bool isBatchingChunkDraws() const { return batchChunkDraws; }
+
+    // Writes chunk vertex buffers from a second GL context on its own thread, see ChunkUploadThread
+    void setThreadedUploads(bool enable) { threadedUploads = enable; }
+    bool isUsingThreadedUploads() const { return threadedUploads; }
+
+    // Draws cross and covered cross plants as instances of their model instead of meshing them into chunks.
+    // Only read when the block mesh table is built
+    void setInstancedPlants(bool enable) { instancedPlants = enable; }
+    bool isUsingInstancedPlants() const { return instancedPlants; }
+
+    // Waits for the display's refresh between frames, the simulation runs at a fixed rate either way
+    void setVsync(bool enable) { vsync = enable; }
+    bool isUsingVsync() const { return vsync; }
+
+    // Streams and draws the instanced cloud layer, see CloudLayer
+    void setCloudsEnabled(bool enable) { cloudsEnabled = enable; }
+    bool isCloudsEnabled() const { return cloudsEnabled; }
+
+    // Frame time in milliseconds the render resolution and view distance are adjusted to hold, 0 disables.
+    // See QualityController
+    void setTargetFrameTime(float milliseconds) { quality.setTargetFrameTime(milliseconds); }
+    float getTargetFrameTime() const { return quality.getTargetFrameTime(); }
+
+    // Set before init, runs the game as a scripted benchmark instead of taking input, see Benchmark
+    void setBenchmark(std::unique_ptr<Benchmark> run) { benchmark = std::move(run); }
+
+    // Times the frame passes on the CPU and GPU, shown in the title and logged to frame_profile.csv
+    void setFrameProfiler(bool enable) { profiler.setEnabled(enable); }
+    bool isUsingFrameProfiler() const { return profiler.isEnabled(); }
+
     std::string getGameVersion() const;
     void setGameVersion(float major, float minor, float patch) {
         gameVersionMajor = major;
@@ -72,9 +141,45 @@ private:
 
     std::unique_ptr<BlockRegister> blockRegister;
 
+    std::unique_ptr<ChunkBufferArena> chunkArena;
+
+    ChunkCuller chunkCuller;
+    std::vector<const ChunkDrawRecord*> visibleChunks;
+    ChunkOcclusionQueries chunkQueries;
+    std::vector<const ChunkDrawRecord*> unqueriedChunks;
+    std::vector<const ChunkDrawRecord*> queriedChunks;
+
     GLFWwindow* window = nullptr;
 
     bool enableFog = false;
+    int lodDistances[2] = { 0, 0 };
+    std::atomic<ChunkRenderMode> chunkRenderMode = ChunkRenderMode::VERTEX_BUFFERS;
+
+    bool batchChunkDraws = true;
+    bool occlusionQueries = false;
+    bool threadedUploads = false;
+    bool instancedPlants = false;
+    bool cloudsEnabled = true;
+    bool vsync = true;
+
+    // GPU mesh memory of the chunks drawn last frame, shown next to the fps to compare the renderers
+    size_t chunkMeshBytes = 0;
+    // Draw calls, triangles and CPU time spent submitting chunks last frame
+    int chunkDrawCalls = 0;
+    size_t chunkTriangles = 0;
+    float chunkDrawMilliseconds = 0.0f;
+
+    FrameProfiler profiler;
+    std::unique_ptr<Benchmark> benchmark;
+
+    // The world is drawn into sceneTarget while the quality controller has lowered the render scale
+    QualityController quality;
+    RenderTarget sceneTarget;
+    bool sceneScaled = false;
+    int framebufferWidth = 0;
+    int framebufferHeight = 0;
+    void beginScene();
+    void presentScene();
 
     float musicVolume = 0.5f;
     float soundVolume = 0.5f;
@@ -89,15 +194,38 @@ private:
     static Game* s_instance;
        
     std::unique_ptr<Shader> shaderProgram;
+    std::unique_ptr<Shader> cutoutShaderProgram;
+    std::unique_ptr<Shader> pullingShaderProgram;
+    std::unique_ptr<Shader> pullingCutoutShaderProgram;
+    std::unique_ptr<Shader> plantShaderProgram;
+    std::unique_ptr<Shader> cloudShaderProgram;
     std::unique_ptr<Shader> uiShaderProgram;
     std::unique_ptr<Shader> wireFrameShaderProgram;
     std::unique_ptr<Texture> atlas;
     std::unique_ptr<Texture> crosshairTex;
     std::unique_ptr<VertexArrayObject> crosshairVAO;
     std::unique_ptr<VertexArrayObject> wireFrameVAO;
+
+    // Block model tables read by the vertex pulling shader, and the attribute-less VAO it draws with
+    BufferTexture modelVertexBuffer;
+    BufferTexture blockModelBuffer;
+    std::unique_ptr<VertexArrayObject> pullingVAO;
+    void uploadBlockModels();
+
+    FrameUniformBuffer frameUniforms;
+    void updateFrameUniforms();
+
+    void drawChunk(const ChunkDrawRecord& record, GLint chunkOriginLocation, bool cutoutPass, bool batched);
+    void drawPlants(const ChunkDrawRecord& record, GLint chunkOriginLocation, GLint firstInstanceLocation);
     
+    // Player movement and physics advance in fixed steps, rendering runs at whatever rate it can
+    static constexpr float SIMULATION_STEP = 1.0f / 60.0f;
+    static constexpr int MAX_SIMULATION_STEPS = 8;
+
     float deltaTime = 0.0f;
-    float lastFrame = 0.0f;
+    double lastFrame = 0.0;
+    // Time not yet simulated, always less than one step between frames
+    float simulationTime = 0.0f;
 };
 
 #endif
@@ -0,0 +1,65 @@
+#ifndef QUALITY_CONTROLLER_H
+#define QUALITY_CONTROLLER_H
+
+#include <chrono>
+#include <string>
+
+class FrameProfiler;
+
+// Holds a target frame time by trading image quality for speed. The CPU time of the frame is taken with
+// steady_clock and the GPU time is what the frame profiler's GL_TIME_ELAPSED queries measured the GPU busy
+// with the render passes, both averaged over a window of frames before anything changes.
+// When the GPU is clearly the slower side the world is drawn at a lower resolution and upscaled, otherwise
+// the view distance comes down, which also cuts chunk streaming. Once both have headroom the resolution
+// comes back first, then the view distance one chunk at a time
+class QualityController {
+    public:
+        static constexpr float MIN_RENDER_SCALE = 0.5f;
+        static constexpr float RENDER_SCALE_STEP = 0.125f;
+        static constexpr int MIN_VIEW_DISTANCE = 6;
+        // Frames averaged before each decision
+        static constexpr int WINDOW_FRAMES = 30;
+        // A frame only counts as GPU bound when the GPU is this much busier than the CPU
+        static constexpr float GPU_BOUND_RATIO = 1.15f;
+        // Quality only goes back up when the frame fits in this much of the target, so it does not flip back and forth
+        static constexpr float RECOVER_FRACTION = 0.75f;
+        // Chunks stream in or out for a while after the view distance changes, their cost is not judged until then
+        static constexpr float VIEW_DISTANCE_SETTLE_SECONDS = 3.0f;
+
+        // Milliseconds per frame to hold, 0 disables the controller
+        void setTargetFrameTime(float milliseconds) { targetMilliseconds = milliseconds; }
+        float getTargetFrameTime() const { return targetMilliseconds; }
+        bool isEnabled() const { return targetMilliseconds > 0.0f; }
+
+        // The view distance from the settings, never exceeded
+        void setMaxViewDistance(int viewDistance);
+
+        void beginFrame();
+        // Needs the profiler enabled with its GPU sections around the render passes
+        void endFrame(const FrameProfiler& profiler);
+
+        // Fraction of the window's resolution the world is drawn at
+        float getRenderScale() const { return renderScale; }
+        int getViewDistance() const { return viewDistance; }
+
+        // Current scale, view distance and timings, for the window title
+        std::string summary() const;
+
+    private:
+        float targetMilliseconds = 0.0f;
+        float renderScale = 1.0f;
+        int viewDistance = 0;
+        int maxViewDistance = 0;
+        std::chrono::steady_clock::time_point settleUntil;
+
+        std::chrono::steady_clock::time_point frameStart;
+        int windowFrames = 0;
+        float cpuSum = 0.0f;
+        float cpuMilliseconds = 0.0f;
+        float gpuMilliseconds = 0.0f;
+
+        void adjust();
+
+};
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef PLAYER_H
 #define PLAYER_H
 
+#include <atomic>
 #include <iostream>
 
 #include "core/player/Camera.h"
@@ -18,7 +19,12 @@ public:
 
     std::optional<glm::ivec3> getHighlightedBlock() const;
 
-    void update(float deltaTime);
+    void simulate(float step);
+    void update(float deltaTime, float interpolation);
+
+    // A scripted player is placed from outside every frame, by the benchmark, and skips input and physics
+    void setScripted(bool isScripted) { scripted = isScripted; }
+    bool isScripted() const { return scripted; }
 
     int gameMode = 0;
     int selectedBlockID = 1;
@@ -36,6 +42,8 @@ public:
 
     glm::vec3 playerSize = glm::vec3(0.6f, 1.8f, 0.6f);
     glm::vec3 playerPosition;
+    // Position before the last simulation step, the camera is interpolated from it
+    glm::vec3 previousPosition;
     const float eyeOffset = .7f;
 
     float distanceSinceLastStep = 0.0f;
@@ -69,14 +77,17 @@ private:
     GLFWwindow* window = nullptr;
 
     std::string playerName = "player";
+    bool scripted = false;
 
+    void handleMovementInput(float deltaTime);
     void handleInput(float deltaTime);
     std::optional<glm::ivec3> highlightedBlock;
     glm::ivec3 highlightedNormal = glm::ivec3(0);
 
     static Player* s_instance;
 
-    int VIEW_DISTANCE = 2;
+    // Read by the chunk threads, lowered and raised at runtime by the quality controller
+    std::atomic<int> VIEW_DISTANCE = 2;
     int NEAR_FOG_DISTANCE = 26;
     int FAR_FOG_DISTANCE = 32;
     int BOTTOM_FOG_DISTANCE = 32;
@@ -4,15 +4,16 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+#include <filesystem>
 #include <stb_image.h>
 
-#include "stb_image_write.h"
 #include "core/registers/BlockRegister.h"
 #include "graphics/Texture.h"
 
-#if defined(_WIN32)
-#include <filesystem>
-#else
+#if !defined(_WIN32)
 #include <dirent.h>
 #endif
 
@@ -22,36 +23,47 @@ struct TextureFile {
     std::string name;
 };
 
-// Create a map of texture names to their corresponding X and Y positions in the atlas
-// std::unordered_map<std::string, std::pair<int, int>> createTextureMap(std::vector<TextureFile> textures, int atlasSize);
-
+// Loads every block texture into one layer of a texture array each, in file name order.
+// The decoded layers are cached in CACHE_FILE next to the textures, keyed by a hash of the texture files'
+// names, sizes and modification times, and only decoded again when one of them changes
 class Atlas {
 public:
+    static constexpr const char* CACHE_FILE = "block_atlas.cache";
+    static constexpr uint32_t CACHE_MAGIC = 0x54414C54;
+    // Bump whenever the layer layout or the file format changes
+    static constexpr uint32_t CACHE_VERSION = 1;
+
     Atlas(const char* path);
     ~Atlas();
 
-    int getSize();
-    Texture* getAtlas();
+    int getLayerCount() const { return numTextures; }
+    int getTileSize() const { return largestTexture; }
+
+    // Creates the GL_TEXTURE_2D_ARRAY with mipmaps from the loaded layers
+    std::unique_ptr<Texture> createTexture(GLuint slot) const;
 
     void linkBlocksToAtlas(BlockRegister* blockRegister);
 
 private:
 
-    int size;
-    int numTextures;
-    int largestTexture;
-    int width;
+    int numTextures = 0;
+    int largestTexture = 1;
+    // Texture coordinate span of one tile
+    const float tileSpan = 1.0f;
     bool blocksLinked = false;
-    Texture* atlas;
 
-    std::unordered_map<std::string, std::pair<int, int>> textureMap;
+    // Layers of largestTexture x largestTexture RGBA pixels, bottom row first as GL expects
+    std::vector<unsigned char> layerData;
+    std::unordered_map<std::string, int> textureMap;
 
     std::vector<TextureFile> loadTextures(const char* path);
+    void buildLayers(std::vector<TextureFile>& textures);
 
-    // Finds the largest square atlas size for a given number of files, in powers of 2
-    int findLargestAtlas(int numFiles);
+    static uint64_t hashSourceFiles(const std::filesystem::path& directory);
+    bool loadCache(const std::filesystem::path& cachePath, uint64_t sourceHash);
+    void saveCache(const std::filesystem::path& cachePath, uint64_t sourceHash) const;
 
-    int findLargestTexture(std::vector<TextureFile> textures);
+    int findLargestTexture(const std::vector<TextureFile>& textures);
 
     // block model linking
     void block_full_linking(Block& block, std::string texture, std::string textureKey, float s, float t);
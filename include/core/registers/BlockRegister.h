@@ -1,6 +1,7 @@
 #ifndef BLOCK_REGISTER_H
 #define BLOCK_REGISTER_H
 
+#include <array>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -22,6 +23,45 @@
 
 std::unordered_map<std::string, BLOCKTYPE> createBlockTypeMap();
 
+// Per-block data flattened for the chunk mesher, indexed by block ID
+// Chunk meshes keep opaque quads ahead of alpha-tested ones so they can be drawn without discard
+constexpr int MESH_BUCKET_OPAQUE = 0;
+constexpr int MESH_BUCKET_CUTOUT = 1;
+constexpr int MESH_BUCKET_COUNT = 2;
+
+// Cross and covered cross blocks can be drawn as instances of their model instead of being copied into chunk meshes
+constexpr int PLANT_MODEL_CROSS = 0;
+constexpr int PLANT_MODEL_COVERED_CROSS = 1;
+constexpr int PLANT_MODEL_COUNT = 2;
+constexpr int8_t NOT_A_PLANT = -1;
+
+struct BlockMeshInfo {
+    BlockModel model = BlockModel::NONE;
+    bool isTransparent = true;
+    uint8_t bucket = MESH_BUCKET_CUTOUT;
+    // Instanced plant model the block is drawn with, NOT_A_PLANT for blocks meshed into the chunk
+    int8_t plantModel = NOT_A_PLANT;
+    uint32_t firstVertex = 0;
+    uint32_t quadCount = 0;
+};
+
+// Model vertices of every block packed into one array, so faces are copied without touching Block
+struct BlockMeshTable {
+    std::vector<BlockMeshInfo> blocks;
+    std::vector<Vertex> vertices;
+
+    // False when a block ID or model is too large to be packed into a 32 bit face record
+    bool fitsFaceRecords = true;
+
+    // Plants are left out of chunk meshes and drawn instanced, every block of a plant model has the same quad count
+    bool instancedPlants = false;
+    std::array<uint32_t, PLANT_MODEL_COUNT> plantModelQuads = {};
+};
+
+// Face records store the quad index within the block model in 4 bits and the block ID in 16
+constexpr uint32_t FACE_RECORD_MAX_QUADS = 16;
+constexpr uint32_t FACE_RECORD_MAX_BLOCKS = 1 << 16;
+
 class BlockRegister {
 public:
     std::vector<Block> blocks;
@@ -30,13 +70,26 @@ public:
     static BlockRegister& instance();
 
     BlockRegister();
+    // Loads blocks from the assets under basePath, for tools that run without a Game
+    explicit BlockRegister(const std::string& basePath);
     ~BlockRegister();
 
     const Block getBlockByName(std::string name);
     const Block getBlockByIndex(int index);
     int getBlockIndex(std::string name);
 
+    // Rebuilds the mesher table, must be called after textures are linked to the block vertices
+    void buildMeshTable();
+    const BlockMeshTable& getMeshTable() const { return meshTable; }
+
+    // Takes effect on the next buildMeshTable
+    void setInstancedPlants(bool enable) { instancedPlants = enable; }
+
 private:
+    BlockMeshTable meshTable;
+    bool instancedPlants = false;
+    std::string basePath;
+
     std::unordered_map<std::string, BLOCKTYPE> blockTypeMap = createBlockTypeMap();
     std::unordered_map<std::string, int> nameToIndexMap;
 
@@ -17,10 +17,17 @@ public:
         cond_var_.notify_one();
     }
 
+    void push(T&& value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopRequested_) return;
+        queue_.push(std::move(value));
+        cond_var_.notify_one();
+    }
+
     bool tryPop(T& value) {
         std::lock_guard<std::mutex> lock(mutex_);
         if (queue_.empty()) return false;
-        value = queue_.front();
+        value = std::move(queue_.front());
         queue_.pop();
         return true;
     }
@@ -33,7 +40,7 @@ public:
 
         if (stopRequested_ && queue_.empty()) return false;
 
-        value = queue_.front();
+        value = std::move(queue_.front());
         queue_.pop();
         return true;
     }
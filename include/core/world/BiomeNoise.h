@@ -11,7 +11,9 @@ struct ChunkPosition;
 namespace BiomeNoise {
 
 
+    // Seeds the calling thread's noise generators, from the world seed unless one is given
     void initializeNoiseGenerator();
+    void initializeNoiseGenerator(int seed);
 
     float generateHills(int x, int z);
 
@@ -42,6 +42,19 @@ enum Face {
     TOP = 5
 };
 
+inline Face oppositeFace(int face) {
+    static const Face opposite[6] = { FRONT, TOP, BACK, RIGHT, LEFT, BOTTOM };
+    return opposite[face];
+}
+
+// Enum for block mesh models, resolved once from Block::model so meshing never compares strings
+enum class BlockModel : uint8_t {
+    NONE,
+    FULL,
+    CROSS,
+    COVERED_CROSS
+};
+
 // Struct for holding block data in a chunk
 struct BlockData {
     uint16_t id;
@@ -73,6 +86,7 @@ struct Block {
 
     std::vector<std::string> textures;
     std::string model;
+    BlockModel modelType = BlockModel::NONE;
 
     std::vector<std::string> states;
 
@@ -2,18 +2,69 @@
 #define CHUNK_H
 
 #include <array>
+#include <atomic>
+#include <mutex>
 #include <stdexcept>
 #include <chrono>
 
 #include "core/registers/BlockRegister.h"
-#include "graphics/VertexArrayObject.h"
+#include "graphics/ChunkBufferArena.h"
+#include "graphics/BufferTexture.h"
 #include "core/threads/ThreadSafeQueue.h"
 #include "core/world/BiomeNoise.h"
+#include "core/world/ChunkVisibility.h"
 
 constexpr int CHUNK_SIZE = 16;
 constexpr int CHUNK_SIZE_P = CHUNK_SIZE + 2;
 constexpr int CHUNK_VOLUME = CHUNK_SIZE_P * CHUNK_SIZE_P * CHUNK_SIZE_P;
 
+// Meshes are laid out in 4x4x4 block cells so an edit only remeshes the cells it touches
+constexpr int MESH_CELL_SIZE = 4;
+constexpr int MESH_CELLS_PER_AXIS = CHUNK_SIZE / MESH_CELL_SIZE;
+constexpr int MESH_CELL_COUNT = MESH_CELLS_PER_AXIS * MESH_CELLS_PER_AXIS * MESH_CELLS_PER_AXIS;
+constexpr uint64_t ALL_MESH_CELLS = ~0ull;
+
+static_assert(MESH_CELL_COUNT <= 64, "Mesh cells must fit in a 64 bit mask");
+
+// Distant chunks are meshed from 2x2x2 (level 1) or 4x4x4 (level 2) downsampled block data
+constexpr int MAX_MESH_LOD = 2;
+
+// Quads are ordered by bucket, then by cell, so every (bucket, cell) pair is one contiguous slot
+constexpr int MESH_SLOT_COUNT = MESH_CELL_COUNT * MESH_BUCKET_COUNT;
+
+// First quad of every mesh slot, plus the total quad count at the end
+using MeshCellRanges = std::array<uint32_t, MESH_SLOT_COUNT + 1>;
+
+// Instances of every plant model in a chunk, the instance list holds them in plant model order
+using PlantInstanceCounts = std::array<uint32_t, PLANT_MODEL_COUNT>;
+
+inline int meshCellIndex(int x, int y, int z) {
+    return (x / MESH_CELL_SIZE) + (z / MESH_CELL_SIZE) * MESH_CELLS_PER_AXIS + (y / MESH_CELL_SIZE) * MESH_CELLS_PER_AXIS * MESH_CELLS_PER_AXIS;
+}
+
+// Mesh cells along one side of the chunk, faces in FACE_OFFSETS order
+inline uint64_t meshBorderCells(int face) {
+    const glm::ivec3 offset = FACE_OFFSETS[face];
+    const int last = MESH_CELLS_PER_AXIS - 1;
+
+    uint64_t cells = 0;
+    for (int cell = 0; cell < MESH_CELL_COUNT; ++cell) {
+        const int cx = cell % MESH_CELLS_PER_AXIS;
+        const int cz = (cell / MESH_CELLS_PER_AXIS) % MESH_CELLS_PER_AXIS;
+        const int cy = cell / (MESH_CELLS_PER_AXIS * MESH_CELLS_PER_AXIS);
+
+        if ((offset.x < 0 && cx == 0) || (offset.x > 0 && cx == last) ||
+            (offset.y < 0 && cy == 0) || (offset.y > 0 && cy == last) ||
+            (offset.z < 0 && cz == 0) || (offset.z > 0 && cz == last)) {
+            cells |= 1ull << cell;
+        }
+    }
+    return cells;
+}
+
+// One bit per face in FACE_OFFSETS order
+constexpr uint8_t ALL_NEIGHBORS = 0x3F;
+
 struct ChunkPosition {
     int x, y, z;
 
@@ -40,17 +91,68 @@ namespace std {
 }
 
 struct ChunkMesh {
-    VertexArrayObject VAO;
+    // Ranges of the shared chunk buffers holding the uploaded vertices and indices
+    ArenaHandle arenaHandle = INVALID_ARENA_HANDLE;
+    // Ranges the upload thread is writing the next mesh into, they replace arenaHandle once written
+    ArenaHandle pendingArenaHandle = INVALID_ARENA_HANDLE;
     std::vector<Vertex> vertices;
     std::vector<GLuint> indices;
 
-    // Chunk mesh thread flags
+    // Chunk mesh thread flags. needsUpdate is set when the blocks change and cleared by the mesh worker
+    // before it reads them, so an edit made while the chunk is meshing is not lost
     bool isUploaded = false;
-    bool needsUpdate = false;
+    std::atomic<bool> needsUpdate = false;
     bool isEmpty = true;
     std::vector<Vertex> stagingVertices;
     std::vector<GLuint> stagingIndices;
     std::atomic<bool> hasNewMesh = false;
+    // Set while the chunk is in the remesh queue or with a mesh worker, so at most one remesh is in flight
+    std::atomic<bool> remeshQueued = false;
+    // Held while the mesh buffers are swapped or copied, a worker hands over a finished mesh while the main
+    // thread may be taking the last one
+    mutable std::mutex stagingMutex;
+
+    // Slot layout of vertices, unknown for meshes saved before it was stored
+    MeshCellRanges cellRanges = {};
+    MeshCellRanges stagingCellRanges = {};
+    bool hasCellRanges = false;
+
+    // Level of detail the vertices were meshed at, 0 is full resolution
+    int lodLevel = 0;
+    int stagingLodLevel = 0;
+
+    // Neighbors whose blocks were known when the border faces towards them were meshed
+    uint8_t meshedNeighbors = 0;
+    uint8_t stagingMeshedNeighbors = 0;
+
+    // Packed faces for the vertex pulling renderer, one per quad in the same order as the vertices.
+    // Only built for full resolution meshes while that renderer is selected
+    std::vector<uint32_t> faceRecords;
+    std::vector<uint32_t> stagingFaceRecords;
+    BufferTexture faceRecordBuffer;
+
+    // One packed position and block ID per instanced plant, see Chunk::generatePlantInstances
+    std::vector<uint32_t> plantInstances;
+    std::vector<uint32_t> stagingPlantInstances;
+    PlantInstanceCounts plantCounts = {};
+    PlantInstanceCounts stagingPlantCounts = {};
+    BufferTexture plantInstanceBuffer;
+    // Plants were left out of the vertices, meshes saved without it still have them baked in
+    bool plantsInstanced = false;
+
+    // Indices before this are opaque, the rest need alpha testing. Without a layout everything is alpha tested
+    size_t getOpaqueIndexCount() const {
+        return getOpaqueQuadCount() * 6;
+    }
+    size_t getOpaqueQuadCount() const {
+        return hasCellRanges ? static_cast<size_t>(cellRanges[MESH_CELL_COUNT]) : 0;
+    }
+
+    // Bytes of GPU memory held by whichever of the two mesh representations is uploaded, plus the plants
+    size_t getGpuBytes() const {
+        return ChunkBufferArena::instance().getAllocationBytes(arenaHandle) + faceRecordBuffer.getCapacity()
+             + plantInstanceBuffer.getCapacity();
+    }
 };
 
 struct SavableChunk {
@@ -58,6 +160,11 @@ struct SavableChunk {
     std::array<uint16_t, CHUNK_VOLUME> blocks;
     std::vector<Vertex> vertices;
     std::vector<GLuint> indices;
+    MeshCellRanges cellRanges = {};
+    bool hasCellRanges = false;
+    int lodLevel = 0;
+    uint8_t meshedNeighbors = 0;
+    bool plantsInstanced = false;
     bool hasMeshUpdate = false;
 };
 
@@ -88,6 +195,7 @@ public:
 
     void setBlocks(const std::array<uint16_t, CHUNK_VOLUME>& newBlocks) {
         blocks = newBlocks;
+        updateVisibility();
     }
     
     void setBlockID(int x, int y, int z, int blockID);
@@ -95,25 +203,48 @@ public:
     ChunkPosition getPosition() const;
     void setPosition(const ChunkPosition& pos);
 
+    // Face to face visibility through the chunk, written by mesh workers and read by the render thread
+    ChunkVisibility getVisibility() const { return { visibility.load(std::memory_order_relaxed) }; }
+    // Recomputes the visibility by flood fill, needed whenever blocks change
+    void updateVisibility();
+
+    // Meshes the chunk, the accessor is called as getBlockIDFromNeighbor(nx, ny, nz) with local
+    // coordinates one block outside the chunk and returns that block's ID, or -1 to skip the face.
+    // Quads are written opaque bucket first, each bucket in mesh cell order. Cells outside cellMask are
+    // skipped and left empty in cellRanges.
+    // Defined in core/world/ChunkMesher.h
+    template <typename NeighborAccessor>
     void generateMesh(std::vector<Vertex>& vertices, std::vector<GLuint>& indices,
-        std::function<int(glm::ivec3 offset, int, int, int)> getBlockIDFromNeighbor) const;
+                      const NeighborAccessor& getBlockIDFromNeighbor,
+                      MeshCellRanges* cellRanges = nullptr, uint64_t cellMask = ALL_MESH_CELLS) const;
+
+    // Meshes the chunk at a reduced level of detail, with all quads of a bucket reported in its first cell
+    void generateLodMesh(std::vector<Vertex>& vertices, std::vector<GLuint>& indices, int lodLevel, MeshCellRanges* cellRanges = nullptr) const;
 
-    void addBlockFaceMesh(const Block& block, int x, int y, int z, int face,
-                          std::vector<Vertex>& vertices, std::vector<GLuint>& indices,
-                          GLuint& indexOffset, glm::vec3 chunkOffset) const;
+    // Remeshes only the cells in dirtyCells and splices them into mesh.vertices/indices in place.
+    // Returns the first vertex that changed, or mesh.vertices.size() if nothing did
+    template <typename NeighborAccessor>
+    size_t remeshCells(uint64_t dirtyCells, const NeighborAccessor& getBlockIDFromNeighbor);
 
-    void addCoveredCrossMesh(const Block& block, int x, int y, int z,
-                             std::vector<Vertex>& vertices, std::vector<GLuint>& indices,
-                             GLuint& indexOffset, glm::vec3 chunkOffset) const;
+    // Writes one 32 bit record per visible quad for the vertex pulling renderer, ordered like generateMesh.
+    // Defined in core/world/ChunkMesher.h
+    template <typename NeighborAccessor>
+    void generateFaceRecords(std::vector<uint32_t>& records, const NeighborAccessor& getBlockIDFromNeighbor) const;
 
-    void addCrossMesh(const Block& block, int x, int y, int z,
-                             std::vector<Vertex>& vertices, std::vector<GLuint>& indices,
-                             GLuint& indexOffset, glm::vec3 chunkOffset) const;
+    // Writes one packed instance per plant block, grouped by plant model. Plants always draw every quad,
+    // so unlike the mesh this needs no neighbors. Empty unless the block mesh table instances plants
+    void generatePlantInstances(std::vector<uint32_t>& instances, PlantInstanceCounts& counts) const;
 
     SavableChunk makeSavableCopy() const;
 
 private:
     std::array<uint16_t, CHUNK_VOLUME> blocks = {0};
+    std::atomic<uint64_t> visibility{ ChunkVisibility::ALL };
+
+    template <typename NeighborAccessor>
+    void resolveFaceMasks(std::array<uint8_t, CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE>& faceMasks,
+                          std::array<uint32_t, MESH_BUCKET_COUNT>& bucketQuads,
+                          const NeighborAccessor& getBlockIDFromNeighbor, uint64_t cellMask) const;
 
     inline int index(int x, int y, int z) const {
         if (x < 0 || x >= CHUNK_SIZE || y < 0 || y >= CHUNK_SIZE || z < 0 || z >= CHUNK_SIZE)
@@ -121,12 +252,6 @@ private:
         return x + (y * CHUNK_SIZE * CHUNK_SIZE) + (z * CHUNK_SIZE);
     }
     
-    inline void getFaceVertices(int face, const Block& block, std::vector<Vertex>& vertices) const {
-        int base = face * 4;
-        for (int i = 0; i < 4; ++i)
-            vertices.push_back(block.vertices[base + i]);
-    }
-    
     ChunkPosition position;
 };
 
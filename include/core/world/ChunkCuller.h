@@ -0,0 +1,89 @@
+#ifndef CHUNK_CULLER_H
+#define CHUNK_CULLER_H
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "core/world/Chunk.h"
+#include "core/world/ChunkRenderList.h"
+#include "graphics/Frustum.h"
+
+// Picks the chunks of a render list inside the view frustum and orders them front to back. Chunks are grouped into vertical columns first, a column
+// outside the frustum culls all of its chunks and a column inside it keeps them without testing each one.
+// With occlusion culling, chunks also have to be reachable from the camera's chunk through faces that
+// see each other (ChunkVisibility), walking away from the camera only. The chunk map is only used for
+// those lookups
+class ChunkCuller {
+    public:
+        struct Stats {
+            int drawn = 0;
+            int culled = 0;
+            int columns = 0;
+            int columnsCulled = 0;
+            // Columns left out for being past the view radius, also counted in columnsCulled
+            int columnsFogged = 0;
+            int occluded = 0;
+        };
+
+        using ChunkMap = std::unordered_map<ChunkPosition, std::shared_ptr<Chunk>, std::hash<ChunkPosition>>;
+
+        void cull(const ChunkRenderList& renderList, const ChunkMap& chunks, const glm::mat4& cameraMatrix,
+                  const glm::vec3& cameraPosition, std::vector<const ChunkDrawRecord*>& visible);
+
+        void setOcclusionCulling(bool enable) { occlusionCulling = enable; }
+        bool isOcclusionCulling() const { return occlusionCulling; }
+
+        // Columns whose nearest point is further than this many blocks from the camera are culled, the fog end.
+        // 0 draws every column
+        void setViewRadius(float blocks) { viewRadius = blocks; }
+
+        const Frustum& getFrustum() const { return frustum; }
+        const Stats& getStats() const { return stats; }
+        // Short summary for the window title
+        std::string summary() const;
+
+    private:
+        struct Column {
+            int x, z;
+            int minY, maxY;
+            uint32_t first = 0;
+            uint32_t count = 0;
+        };
+
+        struct SearchStep {
+            ChunkPosition pos;
+            // Face the step entered the chunk through, 6 for the camera's chunk
+            uint8_t enteredFace;
+            // Directions taken so far, the search never turns back against one of them
+            uint8_t directions;
+        };
+
+        Frustum frustum;
+        Stats stats;
+        bool occlusionCulling = true;
+        float viewRadius = 0.0f;
+
+        bool columnInViewRadius(const Column& column, const glm::vec3& cameraPosition) const;
+        void markReachable(const ChunkMap& chunks, const glm::vec3& cameraPosition, int minY, int maxY);
+        void sortFrontToBack(const glm::vec3& cameraPosition, std::vector<const ChunkDrawRecord*>& visible);
+
+        // Scratch kept between frames so culling does not allocate once the view has settled
+        std::unordered_map<int64_t, uint32_t> columnLookup;
+        std::vector<Column> columns;
+        std::vector<std::pair<const ChunkDrawRecord*, uint32_t>> entries;
+        std::vector<const ChunkDrawRecord*> columnChunks;
+        std::vector<const ChunkDrawRecord*> partialChunks;
+        AABBArray columnBoxes;
+        AABBArray chunkBoxes;
+        std::vector<uint8_t> columnResults;
+        std::vector<uint8_t> chunkResults;
+        std::unordered_map<ChunkPosition, uint8_t, std::hash<ChunkPosition>> reachable;
+        std::vector<SearchStep> searchQueue;
+        std::vector<const ChunkDrawRecord*> frustumVisible;
+        std::vector<std::pair<float, const ChunkDrawRecord*>> sortKeys;
+
+};
+
+#endif
@@ -0,0 +1,325 @@
+#ifndef CHUNK_MESHER_H
+#define CHUNK_MESHER_H
+
+#include "core/world/Chunk.h"
+
+// Neighbor accessor that treats everything outside the chunk as air, so border faces are always emitted
+struct AirNeighborAccessor {
+    int operator()(int nx, int ny, int nz) const { return 0; }
+};
+
+// Deterministic per-position offset for cross models, in [-0.25, 0.25] on X and Z
+inline glm::vec2 crossModelJitter(int worldX, int worldY, int worldZ) {
+    uint32_t h = static_cast<uint32_t>(worldX) * 73856093u
+               ^ static_cast<uint32_t>(worldY) * 19349663u
+               ^ static_cast<uint32_t>(worldZ) * 83492791u;
+    h ^= h >> 16;
+    h *= 0x7feb352du;
+    h ^= h >> 15;
+    h *= 0x846ca68bu;
+    h ^= h >> 16;
+
+    float offsetX = static_cast<float>(h & 0xFFFFu) / 65535.0f;
+    float offsetZ = static_cast<float>(h >> 16) / 65535.0f;
+    return glm::vec2(offsetX * 0.5f - 0.25f, offsetZ * 0.5f - 0.25f);
+}
+
+namespace ChunkMesher {
+    constexpr uint8_t MODEL_BIT = 1 << 6;
+
+    // Copies one quad of a model into the output and writes its two triangles
+    inline void writeQuad(const Vertex* src, const glm::vec3& offset, Vertex* outVertices, GLuint* outIndices, GLuint baseIndex) {
+        for (int i = 0; i < 4; ++i) {
+            outVertices[i] = src[i];
+            outVertices[i].position += offset;
+        }
+
+        outIndices[0] = baseIndex;
+        outIndices[1] = baseIndex + 2;
+        outIndices[2] = baseIndex + 1;
+        outIndices[3] = baseIndex;
+        outIndices[4] = baseIndex + 3;
+        outIndices[5] = baseIndex + 2;
+    }
+
+    // Packs one quad as x | y << 4 | z << 8 | quad << 12 | blockID << 16, where quad indexes the block's model.
+    // Unpacked by shaders/block_pulling.vert
+    inline uint32_t packFaceRecord(int x, int y, int z, uint32_t quad, int blockID) {
+        return static_cast<uint32_t>(x) | (static_cast<uint32_t>(y) << 4) | (static_cast<uint32_t>(z) << 8)
+             | (quad << 12) | (static_cast<uint32_t>(blockID) << 16);
+    }
+
+    // Packs one plant as x | y << 4 | z << 8 | blockID << 16, unpacked by shaders/plant.vert
+    inline uint32_t packPlantInstance(int x, int y, int z, int blockID) {
+        return packFaceRecord(x, y, z, 0, blockID);
+    }
+}
+
+// Resolves the visible faces of every voxel in cellMask into faceMasks and counts the quads of each bucket.
+// Full blocks get one bit per visible face, other models get MODEL_BIT and always emit every quad
+template <typename NeighborAccessor>
+void Chunk::resolveFaceMasks(std::array<uint8_t, CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE>& faceMasks,
+                             std::array<uint32_t, MESH_BUCKET_COUNT>& bucketQuads,
+                             const NeighborAccessor& getBlockIDFromNeighbor, uint64_t cellMask) const
+{
+    const BlockMeshTable& table = BlockRegister::instance().getMeshTable();
+    const BlockMeshInfo* info = table.blocks.data();
+    const int blockCount = static_cast<int>(table.blocks.size());
+
+    for (int cell = 0; cell < MESH_CELL_COUNT; ++cell) {
+        if (!(cellMask & (1ull << cell))) continue;
+        const int cellX = (cell % MESH_CELLS_PER_AXIS) * MESH_CELL_SIZE;
+        const int cellZ = ((cell / MESH_CELLS_PER_AXIS) % MESH_CELLS_PER_AXIS) * MESH_CELL_SIZE;
+        const int cellY = (cell / (MESH_CELLS_PER_AXIS * MESH_CELLS_PER_AXIS)) * MESH_CELL_SIZE;
+
+        for (int y = cellY; y < cellY + MESH_CELL_SIZE; ++y) {
+            for (int z = cellZ; z < cellZ + MESH_CELL_SIZE; ++z) {
+                for (int x = cellX; x < cellX + MESH_CELL_SIZE; ++x) {
+                    const int idx = x + (y * CHUNK_SIZE * CHUNK_SIZE) + (z * CHUNK_SIZE);
+                    const int blockID = blocks[idx];
+                    faceMasks[idx] = 0;
+
+                    if (blockID <= 0 || blockID >= blockCount) continue;
+
+                    const BlockMeshInfo& block = info[blockID];
+                    // Instanced plants are written by generatePlantInstances instead
+                    if (block.model == BlockModel::NONE || block.plantModel != NOT_A_PLANT) continue;
+
+                    if (block.model != BlockModel::FULL) {
+                        faceMasks[idx] = ChunkMesher::MODEL_BIT;
+                        bucketQuads[block.bucket] += block.quadCount;
+                        continue;
+                    }
+
+                    uint8_t mask = 0;
+                    for (int face = 0; face < 6; ++face) {
+                        const int nx = x + FACE_OFFSETS[face].x;
+                        const int ny = y + FACE_OFFSETS[face].y;
+                        const int nz = z + FACE_OFFSETS[face].z;
+
+                        int neighborID;
+                        if (nx < 0 || nx >= CHUNK_SIZE || ny < 0 || ny >= CHUNK_SIZE || nz < 0 || nz >= CHUNK_SIZE) {
+                            neighborID = getBlockIDFromNeighbor(nx, ny, nz);
+                        } else {
+                            neighborID = blocks[nx + (ny * CHUNK_SIZE * CHUNK_SIZE) + (nz * CHUNK_SIZE)];
+                        }
+
+                        if (neighborID < 0 || neighborID >= blockCount) continue;
+                        if (!info[neighborID].isTransparent || neighborID == blockID) continue;
+
+                        mask |= 1 << face;
+                        ++bucketQuads[block.bucket];
+                    }
+                    faceMasks[idx] = mask;
+                }
+            }
+        }
+    }
+}
+
+// Generates the mesh in two passes: the first resolves visible faces into a per-voxel mask and counts quads,
+// the second writes straight into the output, which is resized exactly once
+template <typename NeighborAccessor>
+void Chunk::generateMesh(std::vector<Vertex>& vertices, std::vector<GLuint>& indices,
+                         const NeighborAccessor& getBlockIDFromNeighbor,
+                         MeshCellRanges* cellRanges, uint64_t cellMask) const
+{
+    const BlockMeshTable& table = BlockRegister::instance().getMeshTable();
+    const BlockMeshInfo* info = table.blocks.data();
+
+    std::array<uint8_t, CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE> faceMasks;
+    std::array<uint32_t, MESH_BUCKET_COUNT> bucketQuads = {};
+    resolveFaceMasks(faceMasks, bucketQuads, getBlockIDFromNeighbor, cellMask);
+
+    const uint32_t quadCount = bucketQuads[MESH_BUCKET_OPAQUE] + bucketQuads[MESH_BUCKET_CUTOUT];
+    if (quadCount == 0) {
+        if (cellRanges) cellRanges->fill(0);
+        return;
+    }
+
+    const size_t firstVertex = vertices.size();
+    const size_t firstIndex = indices.size();
+    vertices.resize(firstVertex + quadCount * 4);
+    indices.resize(firstIndex + quadCount * 6);
+
+    Vertex* outVertices = vertices.data() + firstVertex;
+    GLuint* outIndices = indices.data() + firstIndex;
+    GLuint baseIndex = static_cast<GLuint>(firstVertex);
+    uint32_t quad = 0;
+
+    const glm::vec3 chunkOffset = glm::vec3(position.x, position.y, position.z) * (float)CHUNK_SIZE;
+    const Vertex* modelVertices = table.vertices.data();
+
+    for (int slot = 0; slot < MESH_SLOT_COUNT; ++slot) {
+        if (cellRanges) (*cellRanges)[slot] = quad;
+
+        const int bucket = slot / MESH_CELL_COUNT;
+        const int cell = slot % MESH_CELL_COUNT;
+        if (bucketQuads[bucket] == 0 || !(cellMask & (1ull << cell))) continue;
+
+        const int cellX = (cell % MESH_CELLS_PER_AXIS) * MESH_CELL_SIZE;
+        const int cellZ = ((cell / MESH_CELLS_PER_AXIS) % MESH_CELLS_PER_AXIS) * MESH_CELL_SIZE;
+        const int cellY = (cell / (MESH_CELLS_PER_AXIS * MESH_CELLS_PER_AXIS)) * MESH_CELL_SIZE;
+
+        for (int y = cellY; y < cellY + MESH_CELL_SIZE; ++y) {
+            for (int z = cellZ; z < cellZ + MESH_CELL_SIZE; ++z) {
+                for (int x = cellX; x < cellX + MESH_CELL_SIZE; ++x) {
+                    const int idx = x + (y * CHUNK_SIZE * CHUNK_SIZE) + (z * CHUNK_SIZE);
+                    const uint8_t mask = faceMasks[idx];
+                    if (mask == 0) continue;
+
+                    const BlockMeshInfo& block = info[blocks[idx]];
+                    if (block.bucket != bucket) continue;
+
+                    const Vertex* src = modelVertices + block.firstVertex;
+                    glm::vec3 offset = chunkOffset + glm::vec3(x, y, z);
+
+                    if (mask & ChunkMesher::MODEL_BIT) {
+                        if (block.model == BlockModel::CROSS) {
+                            glm::vec2 jitter = crossModelJitter(position.x * CHUNK_SIZE + x, position.y * CHUNK_SIZE + y, position.z * CHUNK_SIZE + z);
+                            offset.x += jitter.x;
+                            offset.z += jitter.y;
+                        }
+
+                        for (uint32_t q = 0; q < block.quadCount; ++q) {
+                            ChunkMesher::writeQuad(src + q * 4, offset, outVertices, outIndices, baseIndex);
+                            outVertices += 4;
+                            outIndices += 6;
+                            baseIndex += 4;
+                        }
+                        quad += block.quadCount;
+                        continue;
+                    }
+
+                    for (int face = 0; face < 6; ++face) {
+                        if (!(mask & (1 << face))) continue;
+                        ChunkMesher::writeQuad(src + face * 4, offset, outVertices, outIndices, baseIndex);
+                        outVertices += 4;
+                        outIndices += 6;
+                        baseIndex += 4;
+                        ++quad;
+                    }
+                }
+            }
+        }
+    }
+    if (cellRanges) (*cellRanges)[MESH_SLOT_COUNT] = quad;
+}
+
+// Writes one packed record per visible quad instead of vertices, in the same slot order as generateMesh
+// so the cell ranges of the vertex mesh describe the records as well
+template <typename NeighborAccessor>
+void Chunk::generateFaceRecords(std::vector<uint32_t>& records, const NeighborAccessor& getBlockIDFromNeighbor) const {
+    const BlockMeshInfo* info = BlockRegister::instance().getMeshTable().blocks.data();
+
+    std::array<uint8_t, CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE> faceMasks;
+    std::array<uint32_t, MESH_BUCKET_COUNT> bucketQuads = {};
+    resolveFaceMasks(faceMasks, bucketQuads, getBlockIDFromNeighbor, ALL_MESH_CELLS);
+
+    const uint32_t quadCount = bucketQuads[MESH_BUCKET_OPAQUE] + bucketQuads[MESH_BUCKET_CUTOUT];
+    if (quadCount == 0) return;
+
+    const size_t firstRecord = records.size();
+    records.resize(firstRecord + quadCount);
+    uint32_t* out = records.data() + firstRecord;
+
+    for (int slot = 0; slot < MESH_SLOT_COUNT; ++slot) {
+        const int bucket = slot / MESH_CELL_COUNT;
+        const int cell = slot % MESH_CELL_COUNT;
+        if (bucketQuads[bucket] == 0) continue;
+
+        const int cellX = (cell % MESH_CELLS_PER_AXIS) * MESH_CELL_SIZE;
+        const int cellZ = ((cell / MESH_CELLS_PER_AXIS) % MESH_CELLS_PER_AXIS) * MESH_CELL_SIZE;
+        const int cellY = (cell / (MESH_CELLS_PER_AXIS * MESH_CELLS_PER_AXIS)) * MESH_CELL_SIZE;
+
+        for (int y = cellY; y < cellY + MESH_CELL_SIZE; ++y) {
+            for (int z = cellZ; z < cellZ + MESH_CELL_SIZE; ++z) {
+                for (int x = cellX; x < cellX + MESH_CELL_SIZE; ++x) {
+                    const int idx = x + (y * CHUNK_SIZE * CHUNK_SIZE) + (z * CHUNK_SIZE);
+                    const uint8_t mask = faceMasks[idx];
+                    if (mask == 0) continue;
+
+                    const int blockID = blocks[idx];
+                    const BlockMeshInfo& block = info[blockID];
+                    if (block.bucket != bucket) continue;
+
+                    if (mask & ChunkMesher::MODEL_BIT) {
+                        for (uint32_t q = 0; q < block.quadCount; ++q) {
+                            *out++ = ChunkMesher::packFaceRecord(x, y, z, q, blockID);
+                        }
+                        continue;
+                    }
+
+                    for (int face = 0; face < 6; ++face) {
+                        if (mask & (1 << face)) *out++ = ChunkMesher::packFaceRecord(x, y, z, face, blockID);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Rebuilds the dirty cells and moves every slot after the first dirty one into place,
+// clean slots are copied as-is since vertex positions are already in world space
+template <typename NeighborAccessor>
+size_t Chunk::remeshCells(uint64_t dirtyCells, const NeighborAccessor& getBlockIDFromNeighbor) {
+    std::vector<Vertex>& vertices = mesh.vertices;
+    std::vector<GLuint>& indices = mesh.indices;
+    MeshCellRanges& ranges = mesh.cellRanges;
+
+    // The opaque bucket comes first, so its first dirty cell is the first dirty slot
+    int firstDirty = 0;
+    while (firstDirty < MESH_CELL_COUNT && !(dirtyCells & (1ull << firstDirty))) ++firstDirty;
+    if (firstDirty == MESH_CELL_COUNT) return vertices.size();
+
+    // Scratch storage is kept per thread, so repeated edits stop allocating once it has grown
+    thread_local std::vector<Vertex> dirtyVertices;
+    thread_local std::vector<GLuint> dirtyIndices;
+    thread_local std::vector<Vertex> tail;
+    dirtyVertices.clear();
+    dirtyIndices.clear();
+    tail.clear();
+
+    MeshCellRanges dirtyRanges;
+    generateMesh(dirtyVertices, dirtyIndices, getBlockIDFromNeighbor, &dirtyRanges, dirtyCells);
+
+    tail.reserve(vertices.size() - ranges[firstDirty] * 4 + dirtyVertices.size());
+
+    MeshCellRanges newRanges = ranges;
+    uint32_t quad = ranges[firstDirty];
+    for (int slot = firstDirty; slot < MESH_SLOT_COUNT; ++slot) {
+        newRanges[slot] = quad;
+
+        bool dirty = dirtyCells & (1ull << (slot % MESH_CELL_COUNT));
+        const MeshCellRanges& srcRanges = dirty ? dirtyRanges : ranges;
+        const Vertex* src = (dirty ? dirtyVertices.data() : vertices.data()) + srcRanges[slot] * 4;
+        uint32_t count = srcRanges[slot + 1] - srcRanges[slot];
+
+        tail.insert(tail.end(), src, src + count * 4);
+        quad += count;
+    }
+    newRanges[MESH_SLOT_COUNT] = quad;
+
+    const size_t firstChanged = static_cast<size_t>(ranges[firstDirty]) * 4;
+    vertices.resize(firstChanged);
+    vertices.insert(vertices.end(), tail.begin(), tail.end());
+
+    // Indices only depend on the quad count, so only new quads need writing
+    size_t oldQuadCount = indices.size() / 6;
+    indices.resize(static_cast<size_t>(quad) * 6);
+    for (size_t q = oldQuadCount; q < quad; ++q) {
+        GLuint base = static_cast<GLuint>(q * 4);
+        GLuint* out = indices.data() + q * 6;
+        out[0] = base;
+        out[1] = base + 2;
+        out[2] = base + 1;
+        out[3] = base;
+        out[4] = base + 3;
+        out[5] = base + 2;
+    }
+
+    ranges = newRanges;
+    return firstChanged;
+}
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef CHUNK_OCCLUSION_QUERIES_H
+#define CHUNK_OCCLUSION_QUERIES_H
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+#include "core/world/Chunk.h"
+#include "core/world/ChunkRenderList.h"
+#include "graphics/Shader.h"
+#include "graphics/VertexArrayObject.h"
+
+// GPU occlusion culling with GL_ANY_SAMPLES_PASSED queries, using last frame's results for this frame.
+// Hidden chunks are skipped and their bounding boxes are drawn against the opaque depth buffer until one passes.
+// Visible chunks are drawn inside a query every few frames to find out when they become hidden.
+// Results are only read once the GPU reports them available, so the pipeline never waits on a query
+class ChunkOcclusionQueries {
+    public:
+        // Visible chunks are retested every this many frames, staggered by position
+        static constexpr uint32_t RETEST_INTERVAL = 15;
+        // States of chunks that were not a candidate for this long are dropped
+        static constexpr uint32_t FORGET_AFTER_FRAMES = 120;
+
+        ChunkOcclusionQueries();
+        ~ChunkOcclusionQueries();
+
+        void init();
+        void deleteBuffers();
+
+        // Collects finished results and splits this frame's candidates into chunks to draw as usual and
+        // chunks to draw inside queries. Chunks last seen hidden are left out of both
+        void beginFrame(const std::vector<const ChunkDrawRecord*>& candidates, const glm::vec3& cameraPosition,
+                        std::vector<const ChunkDrawRecord*>& draw, std::vector<const ChunkDrawRecord*>& drawQueried);
+
+        // Wraps one pass of a chunk from drawQueried, pass 0 is opaque and pass 1 cutout
+        void beginChunkQuery(const ChunkPosition& pos, int pass);
+        void endChunkQuery();
+
+        // Draws the boxes of hidden chunks against the depth buffer with the wireframe shader, after the opaque pass
+        void queryHiddenChunks(Shader& boxShader);
+
+        int getHiddenCount() const { return hiddenCount; }
+
+    private:
+        struct QueryState {
+            // Box queries use the first query, visible retests one per pass
+            GLuint queries[2] = { 0, 0 };
+            uint8_t pendingQueries = 0;
+            bool visible = true;
+            uint32_t lastSeenFrame = 0;
+        };
+
+        std::unordered_map<ChunkPosition, QueryState, std::hash<ChunkPosition>> states;
+        std::vector<ChunkPosition> hiddenChunks;
+        std::unique_ptr<VertexArrayObject> boxVAO;
+        uint32_t frame = 0;
+        int hiddenCount = 0;
+
+        void readResults(QueryState& state);
+        void deleteQueries(QueryState& state);
+
+};
+
+#endif
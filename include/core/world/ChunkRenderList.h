@@ -0,0 +1,46 @@
+#ifndef CHUNK_RENDER_LIST_H
+#define CHUNK_RENDER_LIST_H
+
+#include <memory>
+#include <vector>
+#include <unordered_map>
+
+#include "core/world/Chunk.h"
+
+// What the renderer needs to draw one chunk, copied out of its mesh when the mesh is uploaded.
+// Counts are indices for arena meshes and face records for meshes drawn by vertex pulling
+struct ChunkDrawRecord {
+    // Shared so a chunk replaced in the world's map stays alive for as long as its record is drawn
+    std::shared_ptr<Chunk> chunk;
+    ChunkPosition position;
+    glm::vec3 min;
+    glm::vec3 max;
+    ArenaHandle arenaHandle = INVALID_ARENA_HANDLE;
+    bool pulling = false;
+    uint32_t opaqueCount = 0;
+    uint32_t cutoutCount = 0;
+    // Instanced plants of every plant model, drawn from the mesh's plant instance buffer
+    PlantInstanceCounts plantCounts = {};
+    bool hasPlants = false;
+};
+
+// Dense array of the chunks that have something to draw, kept up to date as meshes are uploaded and
+// chunks unloaded, so the renderer never has to walk the world's chunk map. Removal swaps the last
+// record into the hole, so pointers into the list are only valid until the next change
+class ChunkRenderList {
+    public:
+        // Adds or refreshes the chunk's record from its uploaded mesh, drops it if there is nothing to draw
+        void update(const std::shared_ptr<Chunk>& chunk);
+        void remove(const ChunkPosition& pos);
+        void clear();
+
+        const std::vector<ChunkDrawRecord>& getRecords() const { return records; }
+        size_t size() const { return records.size(); }
+
+    private:
+        std::vector<ChunkDrawRecord> records;
+        std::unordered_map<ChunkPosition, uint32_t, std::hash<ChunkPosition>> indexOf;
+
+};
+
+#endif
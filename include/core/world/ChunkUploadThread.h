@@ -0,0 +1,67 @@
+#ifndef CHUNK_UPLOAD_THREAD_H
+#define CHUNK_UPLOAD_THREAD_H
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <atomic>
+
+#include "core/world/Chunk.h"
+#include "core/threads/ThreadSafeQueue.h"
+
+// Writes chunk meshes into their arena ranges from a hidden window whose context shares objects with the
+// main one. The main thread reserves the ranges and queues a copy of the mesh, the thread writes it and
+// puts a fence behind the writes. Jobs only come back out of collectFinished once their fence has signaled,
+// so the main thread never draws ranges that are still being written and never waits on the GPU
+class ChunkUploadThread {
+    public:
+        struct Job {
+            std::shared_ptr<Chunk> chunk;
+            ArenaHandle handle = INVALID_ARENA_HANDLE;
+            GLuint vertexBuffer = 0;
+            GLuint indexBuffer = 0;
+            GLintptr vertexOffset = 0;
+            GLintptr indexOffset = 0;
+            std::vector<Vertex> vertices;
+            std::vector<GLuint> indices;
+
+            // State from before the upload, for finishing it on the main thread
+            bool wasUploaded = false;
+            int previousLod = 0;
+
+            GLsync fence = nullptr;
+        };
+
+        ChunkUploadThread();
+        ~ChunkUploadThread();
+
+        // Creates the shared context on the calling thread, which GLFW requires to be the main thread
+        bool start(GLFWwindow* mainWindow);
+        // Finishes the queued writes and destroys the context, jobs not collected yet are dropped
+        void stop();
+        bool isRunning() const { return running; }
+
+        void queue(Job&& job);
+        // Moves the jobs whose writes have reached the GPU into out, in the order they were queued
+        void collectFinished(std::vector<Job>& out);
+
+    private:
+        GLFWwindow* context = nullptr;
+        std::thread thread;
+        std::atomic<bool> running = false;
+
+        ThreadSafeQueue<Job> jobs;
+        ThreadSafeQueue<Job> written;
+        // Written jobs waiting on their fence, main thread only
+        std::deque<Job> inFlight;
+        std::vector<Job> arrived;
+
+        void run();
+
+};
+
+#endif
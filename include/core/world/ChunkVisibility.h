@@ -0,0 +1,29 @@
+#ifndef CHUNK_VISIBILITY_H
+#define CHUNK_VISIBILITY_H
+
+#include <cstdint>
+
+// Which faces of a chunk can see each other through its non-opaque blocks, one bit per (from, to) face pair
+// in FACE_OFFSETS order. Used to walk from the camera's chunk to the chunks that can actually be seen
+struct ChunkVisibility {
+    static constexpr uint64_t NONE = 0;
+    static constexpr uint64_t ALL = (1ull << 36) - 1;
+
+    uint64_t faceLinks = ALL;
+
+    bool canSee(int from, int to) const {
+        return (faceLinks >> (from * 6 + to)) & 1;
+    }
+
+    // Links every pair of faces in the mask with each other
+    void connect(uint8_t faces) {
+        for (int from = 0; from < 6; ++from) {
+            if (!(faces & (1 << from))) continue;
+            for (int to = 0; to < 6; ++to) {
+                if (faces & (1 << to)) faceLinks |= 1ull << (from * 6 + to);
+            }
+        }
+    }
+};
+
+#endif
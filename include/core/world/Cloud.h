@@ -1,26 +1,95 @@
 #ifndef CLOUD_H
 #define CLOUD_H
 
+#include <glad/glad.h>
+
+#include <array>
+#include <atomic>
+#include <thread>
+#include <vector>
+
 #include "graphics/VertexArrayObject.h"
+#include "graphics/Shader.h"
+#include "core/threads/ThreadSafeQueue.h"
 
-namespace std {
-    template <>
-    struct hash<glm::ivec2> {
-        std::size_t operator()(const glm::ivec2& v) const noexcept {
-            std::size_t h1 = std::hash<int>{}(v.x);
-            std::size_t h2 = std::hash<int>{}(v.y);
-            return h1 ^ (h2 << 1);
-        }
-    };
-}
-
-struct CloudMesh {
-    VertexArrayObject VAO;
-    std::vector<Vertex> vertices;
-    std::vector<GLuint> indices;
-    bool isUploaded = false;
-};
+class FastNoiseLite;
 
+// Tile coordinates on the cloud grid, in CLOUD_TILE_SIZE steps
 using CloudPosition = glm::ivec2;
 
+// Clouds are boxes on a grid of cells, generated and streamed a tile of cells at a time
+constexpr int CLOUD_CELL_SIZE = 12;
+constexpr int CLOUD_THICKNESS = 4;
+constexpr int CLOUD_HEIGHT = 192;
+constexpr int CLOUD_TILE_CELLS = 16;
+constexpr int CLOUD_CELLS_PER_TILE = CLOUD_TILE_CELLS * CLOUD_TILE_CELLS;
+constexpr int CLOUD_TILE_SIZE = CLOUD_TILE_CELLS * CLOUD_CELL_SIZE;
+
+// Tiles kept on each side of the camera's tile. The ring does not follow the view distance,
+// so the instance count and the cost of drawing it are the same at any render distance
+constexpr int CLOUD_RING_RADIUS = 2;
+constexpr int CLOUD_RING_SIZE = CLOUD_RING_RADIUS * 2 + 1;
+constexpr int CLOUD_TILE_COUNT = CLOUD_RING_SIZE * CLOUD_RING_SIZE;
+
+// Blocks per second the clouds drift along +X
+constexpr float CLOUD_DRIFT_SPEED = 1.5f;
+
+// Streams cloud tiles around the camera through a ring of tile slots, the way chunks are kept around the player.
+// A worker thread turns noise into packed cells, the main thread copies at most a few finished tiles per frame
+// into the slot's range of one instance buffer, and every slot is drawn with a single instanced call
+class CloudLayer {
+    public:
+        CloudLayer();
+        ~CloudLayer();
+
+        // Creates the buffers on the calling thread, which needs the GL context, and starts the worker
+        void start(int seed);
+        // Joins the worker and deletes the buffers, tiles still being generated are dropped
+        void stop();
+        bool isRunning() const { return running; }
+
+        // Requests the tiles that moved into the ring and uploads finished ones
+        void update(const glm::vec3& cameraPosition, float time);
+        void draw(Shader& cloudShader);
+
+    private:
+        // x | z << 4 | occupied << 8 | covered sides << 9, the sides in -X, +X, -Z, +Z order.
+        // Unpacked by shaders/cloud.vert
+        using CloudCell = uint32_t;
+
+        struct Tile {
+            CloudPosition position;
+            std::array<CloudCell, CLOUD_CELLS_PER_TILE> cells;
+        };
+
+        struct Slot {
+            CloudPosition position;
+            bool requested = false;
+            bool ready = false;
+        };
+
+        // Tiles copied into the instance buffer per frame, a tile is one kilobyte
+        static constexpr int MAX_TILE_UPLOADS = 2;
+
+        std::thread worker;
+        std::atomic<bool> running = false;
+        int seed = 0;
+
+        ThreadSafeQueue<CloudPosition> requests;
+        ThreadSafeQueue<Tile> finished;
+
+        std::array<Slot, CLOUD_TILE_COUNT> slots;
+        // xz origin of the tile in each slot, w is 1 once its cells are uploaded
+        std::array<glm::vec4, CLOUD_TILE_COUNT> tileOrigins = {};
+        float drift = 0.0f;
+
+        VertexArrayObject boxVAO;
+        GLuint instanceBuffer = 0;
+
+        void workerThread();
+        static void generateTile(const FastNoiseLite& noise, const CloudPosition& position, Tile& tile, std::vector<uint8_t>& occupied);
+        static int slotIndex(const CloudPosition& position);
+
+};
+
 #endif
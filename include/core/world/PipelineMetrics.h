@@ -0,0 +1,60 @@
+#ifndef PIPELINE_METRICS_H
+#define PIPELINE_METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/world/Chunk.h"
+
+// Counters for the chunk pipeline, written by the worker threads and read by the main thread
+class PipelineMetrics {
+public:
+    static PipelineMetrics& instance();
+
+    void recordMesh(int lodLevel, int allocations, int64_t microseconds);
+    void recordPartialRemesh(int allocations);
+    void recordBorderRemesh() { borderRemeshes.fetch_add(1, std::memory_order_relaxed); }
+    void recordChunkLoaded() { chunksLoaded.fetch_add(1, std::memory_order_relaxed); }
+    void recordMeshUpload(size_t bytes) { uploadedMeshBytes.fetch_add(bytes, std::memory_order_relaxed); }
+
+    // Load latency is the time from a chunk position being queued for generation to its first mesh being drawable.
+    // Only tracked while enabled, since it keeps a timestamp per requested chunk
+    void setTrackingLoadLatency(bool enable);
+    void recordChunkRequested(const ChunkPosition& pos);
+    void recordChunkRequestDropped(const ChunkPosition& pos);
+    void recordChunkDrawable(const ChunkPosition& pos);
+    std::vector<float> getLoadLatencies() const;
+
+    uint64_t getMeshCount() const { return meshes.load(std::memory_order_relaxed); }
+    uint64_t getLodMeshCount() const { return lodMeshes.load(std::memory_order_relaxed); }
+    uint64_t getPartialRemeshCount() const { return partialRemeshes.load(std::memory_order_relaxed); }
+    uint64_t getMeshAllocationCount() const { return meshAllocations.load(std::memory_order_relaxed); }
+    uint64_t getBorderRemeshCount() const { return borderRemeshes.load(std::memory_order_relaxed); }
+    uint64_t getChunksLoadedCount() const { return chunksLoaded.load(std::memory_order_relaxed); }
+    uint64_t getUploadedMeshBytes() const { return uploadedMeshBytes.load(std::memory_order_relaxed); }
+
+    // Short summary for the window title
+    std::string summary() const;
+
+private:
+    std::atomic<uint64_t> meshes{0};
+    std::atomic<uint64_t> lodMeshes{0};
+    std::atomic<uint64_t> partialRemeshes{0};
+    std::atomic<uint64_t> meshAllocations{0};
+    std::atomic<uint64_t> meshMicroseconds{0};
+    std::atomic<uint64_t> borderRemeshes{0};
+    std::atomic<uint64_t> chunksLoaded{0};
+    std::atomic<uint64_t> uploadedMeshBytes{0};
+
+    std::atomic<bool> trackingLoadLatency{false};
+    mutable std::mutex latencyMutex;
+    std::unordered_map<ChunkPosition, std::chrono::steady_clock::time_point> requestTimes;
+    std::vector<float> loadLatencies;
+};
+
+#endif
@@ -16,6 +16,8 @@
 #define NOMINMAX
 
 #include <unordered_set>
+#include <algorithm>
+#include <climits>
 #include <chrono>
 #include <ctime>
 #include <zstd.h>
@@ -23,11 +25,43 @@
 
 #include "core/world/Chunk.h"
 #include "core/world/Cloud.h"
+#include "core/world/ChunkRenderList.h"
+#include "core/world/ChunkUploadThread.h"
 #include "graphics/Shader.h"
 #include "network/TCPSocket.h"
 
 class Player;
 
+// Reads the blocks just outside a chunk from its six neighbors, looked up once before meshing so it is safe
+// on any thread. Missing neighbors read as air, which keeps the border faces towards them
+struct ChunkNeighborAccessor {
+    std::array<std::shared_ptr<Chunk>, 6> neighbors;
+
+    int operator()(int nx, int ny, int nz) const {
+        int face = nx < 0 ? LEFT : nx >= CHUNK_SIZE ? RIGHT : ny < 0 ? BOTTOM : ny >= CHUNK_SIZE ? TOP : nz < 0 ? BACK : FRONT;
+        const std::shared_ptr<Chunk>& neighbor = neighbors[face];
+        if (!neighbor) return 0;
+        return neighbor->getBlockID((nx + CHUNK_SIZE) % CHUNK_SIZE, (ny + CHUNK_SIZE) % CHUNK_SIZE, (nz + CHUNK_SIZE) % CHUNK_SIZE);
+    }
+
+    // Neighbors that exist, including ones left out because they are meshed at a lower level of detail
+    uint8_t knownNeighbors = 0;
+};
+
+// Blocks from the player's chunk to the fog end at a view distance, matches Player::syncViewDistance
+inline float viewRadiusBlocks(int viewDistance) {
+    return viewDistance * static_cast<float>(CHUNK_SIZE) - 1.0f;
+}
+
+// Chunks are loaded, meshed and kept within a circle around the player's chunk instead of a square. A column
+// at chunk offset (dx, dz) is in range while its nearest point to anywhere in the player's chunk is closer than
+// radius blocks, so the corners of the square, which are entirely past the fog end, are left out
+inline bool isColumnInViewRange(int dx, int dz, float radius) {
+    const float nearX = std::max(std::abs(dx) - 1, 0) * static_cast<float>(CHUNK_SIZE);
+    const float nearZ = std::max(std::abs(dz) - 1, 0) * static_cast<float>(CHUNK_SIZE);
+    return nearX * nearX + nearZ * nearZ < radius * radius;
+}
+
 class World {
 public:
     explicit World(const std:: string& saveDir = "saves/");
@@ -54,8 +88,21 @@ public:
     void pollTCPMessages();
 
     void generateMesh(const std::shared_ptr<Chunk>& chunk);
+    // Queues a full remesh, a chunk already queued or being meshed is only marked as changed
+    void queueRemesh(const std::shared_ptr<Chunk>& chunk);
+    int lodLevelForChunk(const ChunkPosition& pos) const;
+    void updateChunkLods();
+    bool wantsFaceRecords(int lodLevel) const;
+    void remeshUploadedChunks();
 
     void setBlockAtWorldPosition(int wx, int wy, int wz, int blockID);
+    void remeshDirtyCells(const std::shared_ptr<Chunk>& chunk, uint64_t dirtyCells, uint8_t resolvedNeighbors = 0);
+
+    void registerGeneratedChunk(const std::shared_ptr<Chunk>& chunk);
+    void unregisterGeneratedChunk(const ChunkPosition& pos);
+    ChunkNeighborAccessor makeNeighborAccessor(const ChunkPosition& pos) const;
+    void queueMissingNeighborRemeshes(const Chunk& chunk);
+    void processBorderRemeshes(int maxPerFrame = 8);
 
     void queueChunksForMeshing(const glm::vec3& playerPos);
     void updateChunksAroundPlayer(const glm::ivec3& playerChunk, const int VIEW_DISTANCE);
@@ -63,9 +110,21 @@ public:
 
     void uploadChunkMeshes(int maxPerFrame = 2);
     void uploadMeshToGPU(Chunk& chunk);
+    void swapInStagedMesh(ChunkMesh& mesh);
+    void finishMeshUpload(const std::shared_ptr<Chunk>& chunk, bool wasUploaded, int previousLod);
+    void uploadMeshRange(Chunk& chunk, size_t firstVertex, size_t oldIndexCount);
+    void uploadPlantInstances(ChunkMesh& mesh);
 
     void uploadChunksToMap();
 
+    // Moves vertex buffer uploads off the main thread, see ChunkUploadThread. Falls back to uploading on
+    // the main thread when the shared context cannot be created
+    void startUploadThread(GLFWwindow* mainWindow);
+    void stopUploadThread();
+    bool queueThreadedUpload(const std::shared_ptr<Chunk>& chunk, bool wasUploaded, int previousLod);
+    void collectThreadedUploads();
+
+    void releaseChunkMesh(Chunk& chunk);
     void queueChunksForRemoval(const glm::ivec3& centerChunk, const int VIEW_DISTANCE);
     void unloadDistantChunks();
 
@@ -95,17 +154,13 @@ public:
 
     std::unordered_map<ChunkPosition, std::shared_ptr<Chunk>, std::hash<ChunkPosition>> chunks;
     std::unordered_set<ChunkPosition> chunkPositionSet;
-
-    std::unordered_map<CloudPosition, CloudMesh> clouds;
-    std::unordered_set<CloudPosition> activeClouds;
+    // Chunks with an uploaded mesh to draw, updated on the main thread alongside the GPU buffers
+    ChunkRenderList renderList;
 
     std::atomic<bool> needsFullReset = false;
 
-    // Clouds
-    std::vector<Vertex> cloudVertices;
-    std::vector<GLuint> cloudIndices;
-    VertexArrayObject cloudVAO;
-    bool cloudsUploaded = false;
+    // Streamed around the camera on its own worker, started by the game once the seed is known
+    CloudLayer clouds;
 
     void updateCloudsAroundPlayer();
     void drawClouds(Shader& cloudShader);
@@ -128,10 +183,36 @@ private:
 
     ThreadSafeQueue<std::shared_ptr<Chunk>> meshUpdateQueue;
 
+    std::unique_ptr<ChunkUploadThread> uploadThread;
+    std::vector<ChunkUploadThread::Job> finishedUploads;
+
+    // Every chunk whose blocks exist, including chunks still on their way through the mesh workers,
+    // so workers can read neighbor blocks before the main thread has inserted them into chunks
+    std::unordered_map<ChunkPosition, std::shared_ptr<Chunk>> generatedChunks;
+    mutable std::mutex generatedChunksMutex;
+
+    // Border faces to remesh on the main thread once the neighbor behind them is known. A face is queued
+    // at most once until it is processed, the masks hold the queued and forced faces of every chunk
+    struct BorderRemesh {
+        ChunkPosition position;
+        int face;
+    };
+    struct PendingBorderFaces {
+        uint8_t queued = 0;
+        uint8_t forced = 0;
+    };
+    ThreadSafeQueue<BorderRemesh> borderRemeshQueue;
+    std::unordered_map<ChunkPosition, PendingBorderFaces> pendingBorderRemeshes;
+    std::mutex borderRemeshMutex;
+    void queueBorderRemesh(const ChunkPosition& pos, int face, bool force);
+    bool takeBorderRemesh(const BorderRemesh& task);
+
     SOCKET tcpSocket;
 
     uint32_t seed = 1;
 
+    glm::ivec3 lastLodCenter = {INT_MAX, 0, INT_MAX};
+
     int minY = -5;
     int maxY = 15;
 
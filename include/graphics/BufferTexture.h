@@ -0,0 +1,31 @@
+#ifndef BUFFER_TEXTURE_H
+#define BUFFER_TEXTURE_H
+
+#include <cstddef>
+#include <glad/glad.h>
+
+// Buffer object exposed to shaders as a samplerBuffer/usamplerBuffer, read with texelFetch
+class BufferTexture {
+    public:
+        BufferTexture();
+        ~BufferTexture();
+
+        // Replaces the contents, the buffer is only reallocated when the data no longer fits
+        void upload(const void* data, size_t bytes, GLenum internalFormat, GLenum usage = GL_STATIC_DRAW);
+
+        // Binds the texture to the given texture unit
+        void bind(GLuint unit) const;
+        void deleteBuffers();
+
+        bool isInitialized() const { return texture != 0; }
+        size_t getSize() const { return size; }
+        size_t getCapacity() const { return capacity; }
+
+    private:
+        GLuint buffer, texture;
+        size_t size = 0;
+        size_t capacity = 0;
+
+};
+
+#endif
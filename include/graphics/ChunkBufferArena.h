@@ -0,0 +1,160 @@
+#ifndef CHUNK_BUFFER_ARENA_H
+#define CHUNK_BUFFER_ARENA_H
+
+#include <vector>
+#include <map>
+#include <string>
+#include <cstdint>
+#include <glad/glad.h>
+
+#include "graphics/Vertex.h"
+
+// First fit free list over [0, capacity), neighboring free ranges are merged when released
+class RangeAllocator {
+    public:
+        static constexpr uint32_t INVALID_OFFSET = UINT32_MAX;
+
+        explicit RangeAllocator(uint32_t capacity = 0);
+
+        // Returns the offset of size free units, or INVALID_OFFSET when no free range is large enough
+        uint32_t allocate(uint32_t size);
+        // Same as allocate, but the range has to end at or before limit
+        uint32_t allocateBelow(uint32_t size, uint32_t limit);
+        void release(uint32_t offset, uint32_t size);
+
+        uint32_t getCapacity() const { return capacity; }
+        uint32_t getFreeUnits() const { return freeUnits; }
+        uint32_t getLargestFreeRange() const;
+
+    private:
+        // Offset -> size of every free range
+        std::map<uint32_t, uint32_t> freeRanges;
+        uint32_t capacity = 0;
+        uint32_t freeUnits = 0;
+
+};
+
+using ArenaHandle = uint32_t;
+constexpr ArenaHandle INVALID_ARENA_HANDLE = UINT32_MAX;
+
+// Where a mesh lives in the arena. Indices stay relative to the mesh, draws add firstVertex as the base vertex
+struct ArenaAllocation {
+    int page = -1;
+    uint32_t firstVertex = 0;
+    uint32_t vertexCapacity = 0;
+    uint32_t vertexCount = 0;
+    uint32_t firstIndex = 0;
+    uint32_t indexCapacity = 0;
+    uint32_t indexCount = 0;
+    // Set while another thread is writing the ranges, defragment leaves them where they are
+    bool pinned = false;
+};
+
+// Chunk meshes sub-allocated from a few large vertex and index buffers, every page shares one VAO.
+// Meshes are written with glBufferSubData into their ranges, so remeshing never creates GL objects.
+// Handles stay valid while defragment moves the ranges behind them
+class ChunkBufferArena {
+    public:
+        struct Stats {
+            size_t pages = 0;
+            size_t allocations = 0;
+            size_t capacityBytes = 0;
+            size_t usedBytes = 0;
+            size_t freeBytes = 0;
+            // 0 when all free space is one range, towards 1 the more it is split up
+            float fragmentation = 0.0f;
+        };
+
+        static void setInstance(ChunkBufferArena* instance);
+        static ChunkBufferArena& instance();
+
+        ChunkBufferArena(uint32_t pageVertices = 1 << 20, uint32_t pageIndices = 3 << 19);
+        ~ChunkBufferArena();
+
+        // Writes a whole mesh, in place when the handle's ranges are large enough, otherwise into new ranges
+        // with headroom extra capacity (0.25 = 25%). An invalid handle is allocated
+        bool upload(ArenaHandle& handle, const std::vector<Vertex>& vertices, const std::vector<GLuint>& indices, float headroom = 0.0f);
+        // Rewrites vertices from firstVertex and indices from firstIndex in place,
+        // false when the mesh has outgrown its ranges and needs a full upload
+        bool update(ArenaHandle handle, const std::vector<Vertex>& vertices, size_t firstVertex, const std::vector<GLuint>& indices, size_t firstIndex);
+        void release(ArenaHandle& handle);
+        // Allocates a new handle with ranges for the mesh without writing anything, pinned until unpin.
+        // The ranges can then be filled through the page buffers from another context
+        bool reserve(ArenaHandle& handle, size_t vertexCount, size_t indexCount);
+        void unpin(ArenaHandle handle);
+        GLuint getVertexBuffer(int page) const { return pages[page].VBO; }
+        GLuint getIndexBuffer(int page) const { return pages[page].EBO; }
+
+        bool isValid(ArenaHandle handle) const { return handle < allocations.size() && allocations[handle].page >= 0; }
+        const ArenaAllocation& get(ArenaHandle handle) const { return allocations[handle]; }
+        size_t getAllocationBytes(ArenaHandle handle) const;
+
+        // Binds the VAO of a page, a no-op when it is already bound
+        void bindPage(int page);
+        void unbind();
+
+        // Draw batching: addDraw queues count indices from firstIndex of a mesh, drawBatch then submits
+        // every queued draw with one multi-draw per page and returns the number of draw calls issued.
+        // Uses glMultiDrawElementsIndirect on GL 4.3 contexts, glMultiDrawElementsBaseVertex otherwise
+        void beginBatch();
+        void addDraw(ArenaHandle handle, size_t firstIndex, size_t indexCount);
+        int drawBatch();
+        bool usesIndirectDraws() const { return indirectDraws; }
+
+        // Moves up to maxMoves ranges into free space lower in their page once free space is fragmented,
+        // and frees pages that no longer hold any mesh. Does no work while the layout is unchanged since
+        // a pass that could not move anything
+        void defragment(int maxMoves = 16);
+
+        Stats getStats() const;
+        std::string summary() const;
+
+        void deleteBuffers();
+
+    private:
+        struct Page {
+            GLuint VAO = 0, VBO = 0, EBO = 0;
+            RangeAllocator vertices;
+            RangeAllocator indices;
+            uint32_t liveAllocations = 0;
+        };
+
+        // Laid out as GL expects in the indirect buffer
+        struct DrawElementsIndirectCommand {
+            GLuint count;
+            GLuint instanceCount;
+            GLuint firstIndex;
+            GLint baseVertex;
+            GLuint baseInstance;
+        };
+
+        std::vector<Page> pages;
+        std::vector<ArenaAllocation> allocations;
+        std::vector<ArenaHandle> freeHandles;
+        uint32_t pageVertices, pageIndices;
+        int boundPage = -1;
+        // Set when ranges are allocated, freed or unpinned, defragment skips its pass while it is clear
+        bool layoutChanged = false;
+
+        // Queued draws of every page, cleared but not freed between frames
+        std::vector<std::vector<DrawElementsIndirectCommand>> batches;
+        std::vector<DrawElementsIndirectCommand> indirectCommands;
+        std::vector<GLsizei> batchCounts;
+        std::vector<const void*> batchOffsets;
+        std::vector<GLint> batchBaseVertices;
+        bool indirectDraws = false;
+        GLuint indirectBuffer = 0;
+        size_t indirectBufferCapacity = 0;
+
+        static ChunkBufferArena* s_instance;
+
+        int createPage();
+        void destroyPage(int page);
+        bool allocateRanges(ArenaAllocation& allocation, uint32_t vertexCapacity, uint32_t indexCapacity);
+        void releaseRanges(ArenaAllocation& allocation);
+        void writeVertices(const ArenaAllocation& allocation, const Vertex* data, size_t first, size_t count);
+        void writeIndices(const ArenaAllocation& allocation, const GLuint* data, size_t first, size_t count);
+
+};
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef FRAME_PROFILER_H
+#define FRAME_PROFILER_H
+
+#include <glad/glad.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Splits frame time into named sections, timed on the CPU with steady_clock and on the GPU with
+// GL_TIME_ELAPSED queries. Every section has QUERY_BUFFERS queries used round robin, a result is read
+// when its query comes up again and only if the GPU reports it available, so reading never stalls.
+// GPU sections cannot nest, since only one GL_TIME_ELAPSED query can be active at a time
+class FrameProfiler {
+    public:
+        static constexpr int MAX_SECTIONS = 8;
+        static constexpr int QUERY_BUFFERS = 2;
+        // Frames the averages and percentiles are taken over
+        static constexpr int HISTORY = 120;
+
+        // Times one section for as long as it is in scope
+        class Scope {
+            public:
+                Scope(FrameProfiler& profiler, const char* name, bool gpu = true);
+                ~Scope();
+
+            private:
+                FrameProfiler& profiler;
+                int section;
+        };
+
+        void setEnabled(bool enable) { enabled = enable; }
+        bool isEnabled() const { return enabled; }
+
+        // Appends one row per section and frame to a CSV file, GPU times follow QUERY_BUFFERS frames late
+        bool openLog(const std::string& path);
+
+        void beginFrame();
+        void endFrame();
+
+        int beginSection(const char* name, bool gpu);
+        void endSection(int section);
+
+        // Rolling averages and 95th percentiles, for the window title
+        std::string summary() const;
+        // What the GPU spent on the timed sections of a frame, averaged over the latest frames with results
+        float recentGpuMilliseconds(int frames) const;
+
+        void deleteQueries();
+
+    private:
+        struct Section {
+            const char* name = nullptr;
+            bool gpu = false;
+            std::chrono::steady_clock::time_point start;
+
+            std::array<GLuint, QUERY_BUFFERS> queries = {};
+            std::array<bool, QUERY_BUFFERS> pending = {};
+            std::array<uint64_t, QUERY_BUFFERS> queryFrames = {};
+            std::array<float, QUERY_BUFFERS> queryCpuMilliseconds = {};
+
+            std::array<float, HISTORY> cpuHistory = {};
+            std::array<float, HISTORY> gpuHistory = {};
+            int cpuSamples = 0;
+            int gpuSamples = 0;
+        };
+
+        bool enabled = false;
+        uint64_t frame = 0;
+        std::vector<Section> sections;
+        std::ofstream log;
+
+        void readQuery(Section& section, int buffer);
+        static void pushSample(std::array<float, HISTORY>& history, int& samples, float value);
+        static void stats(const std::array<float, HISTORY>& history, int samples, float& average, float& p95);
+
+};
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef FRAME_UNIFORMS_H
+#define FRAME_UNIFORMS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// Values shared by every world shader for one frame, laid out like the std140 FrameUniforms block
+// declared at the top of the block, cloud, light and wireframe shaders. Keep both in sync
+struct FrameUniformData {
+    glm::mat4 cameraMatrix = glm::mat4(1.0f);
+    glm::vec4 camPos = glm::vec4(0.0f);
+    glm::vec4 lightDir = glm::vec4(0.0f);
+    glm::vec4 lightColor = glm::vec4(1.0f);
+    // rgb, fog density in w
+    glm::vec4 fogColor = glm::vec4(0.0f);
+    // Fog start, end and bottom distance, w is 1 when fog is enabled
+    glm::vec4 fogParams = glm::vec4(0.0f);
+    glm::vec4 foliageColor = glm::vec4(0.0f);
+};
+
+// Uniform buffer holding FrameUniformData, written once per frame and bound to BINDING for all shaders
+class FrameUniformBuffer {
+    public:
+        static constexpr GLuint BINDING = 0;
+        static constexpr const char* BLOCK_NAME = "FrameUniforms";
+
+        FrameUniformBuffer();
+        ~FrameUniformBuffer();
+
+        void init();
+        void update(const FrameUniformData& data);
+        void deleteBuffers();
+
+    private:
+        GLuint UBO = 0;
+
+};
+
+#endif
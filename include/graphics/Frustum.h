@@ -0,0 +1,46 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+// Axis aligned boxes stored as center and half extent arrays, so a frustum test runs down each array
+// with the same arithmetic per box and the compiler can vectorize it
+struct AABBArray {
+    std::vector<float> centerX, centerY, centerZ;
+    std::vector<float> extentX, extentY, extentZ;
+
+    void push(const glm::vec3& min, const glm::vec3& max);
+    void clear();
+    size_t size() const { return centerX.size(); }
+};
+
+// The six planes of a view projection matrix, normals point into the view volume
+class Frustum {
+    public:
+        enum Result : uint8_t {
+            OUTSIDE = 0,
+            INTERSECTS = 1,
+            INSIDE = 2
+        };
+
+        Frustum() = default;
+        explicit Frustum(const glm::mat4& viewProjection) { update(viewProjection); }
+
+        // Extracts the planes from a clip space matrix like Camera::cameraMatrix
+        void update(const glm::mat4& viewProjection);
+
+        Result classify(const glm::vec3& min, const glm::vec3& max) const;
+        // Classifies every box of the array into results, one Result per box
+        void classify(const AABBArray& boxes, std::vector<uint8_t>& results) const;
+
+        const glm::vec4& getPlane(int plane) const { return planes[plane]; }
+
+    private:
+        // Left, right, bottom, top, near, far as (normal, distance)
+        glm::vec4 planes[6] = {};
+
+};
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef RENDER_TARGET_H
+#define RENDER_TARGET_H
+
+#include <glad/glad.h>
+
+// Offscreen framebuffer with a color and a depth renderbuffer. The world is drawn into it below the window's
+// resolution and stretched over the default framebuffer with a linear blit
+class RenderTarget {
+    public:
+        RenderTarget();
+        ~RenderTarget();
+
+        // Creates the framebuffer on first use and reallocates the attachments when the size changed.
+        // Returns false if the driver reports the framebuffer incomplete
+        bool resize(int width, int height);
+
+        // Binds the framebuffer for drawing and sets the viewport to its size
+        void bind() const;
+        // Scales the color attachment over the whole default framebuffer and leaves it bound with a matching viewport
+        void blitToScreen(int screenWidth, int screenHeight) const;
+        void deleteBuffers();
+
+        bool isInitialized() const { return framebuffer != 0; }
+        int getWidth() const { return width; }
+        int getHeight() const { return height; }
+
+    private:
+        GLuint framebuffer, colorBuffer, depthBuffer;
+        int width = 0;
+        int height = 0;
+        bool complete = false;
+
+};
+
+#endif
@@ -6,6 +6,7 @@
 #include <sstream>
 #include <fstream>
 #include <vector>
+#include <unordered_map>
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -15,6 +16,7 @@
 class Shader {
     public:
         Shader(const std::string& vertexShaderPath, const std::string& fragmentShaderPath, std::string geometryShaderPath = "");
+        Shader(const std::string& vertexShaderPath, const std::string& fragmentShaderPath, const std::vector<std::string>& defines);
         Shader();
         ~Shader();
 
@@ -37,12 +39,34 @@ class Shader {
         void setFloat(const std::string& name, float value);
         void setInt(const std::string& name, int value);
 
+        // Location of an active uniform, cached when the program is linked. -1 when there is no such uniform.
+        // Hot paths look the location up once and use the overloads below, which skip the name entirely
+        GLint getUniformLocation(const std::string& name) const;
+
+        void setMat4(GLint location, const glm::mat4& mat);
+        void setUniform3(GLint location, const glm::vec3& vec);
+        void setFloat(GLint location, float value);
+        void setInt(GLint location, int value);
+
+        // Points a uniform block of this program at a buffer binding, does nothing if the program lacks the block
+        void bindUniformBlock(const char* blockName, GLuint binding);
+
     private:
+        // Program last made current through use(), so repeated use() calls do not reach the driver
+        static GLuint s_currentProgram;
+
+        std::unordered_map<std::string, GLint> uniformLocations;
+
+        // Injected as #define lines after #version, so one source file can build several variants
+        std::vector<std::string> defines;
+
         std::string readFile(const char* filename);
+        std::string injectDefines(const std::string& source) const;
 
         GLuint genShader(const char* filepath, GLenum type);
 
         GLuint genShaderProgram(const char* vertexShaderPath, const char* fragmentShaderPath, const char* geometryShaderPath = "");
+        void cacheUniformLocations();
 };
 
 #endif
@@ -13,6 +13,8 @@ class Texture {
 
     public:
         Texture(const char* path, GLenum texType, GLuint texSlot, GLenum format, GLenum pixelType, GLenum minMagFilter = GL_NEAREST, GLenum wrapFilter = GL_REPEAT);
+        // Creates a GL_TEXTURE_2D_ARRAY from layers of RGBA pixels with a full mipmap chain, tiles repeat
+        Texture(const unsigned char* layerData, int width, int height, int layers, GLuint texSlot);
         Texture();
         ~Texture(); 
 
@@ -20,6 +22,7 @@ class Texture {
         GLenum type, pixelType;
         GLuint slot, ID, texUniform;
         int width, height, nrChannels;
+        int layers = 1;
 
         // Binds the texture object in openGL
         void bind();
@@ -29,7 +32,7 @@ class Texture {
         void deleteTexture();
 
         // Sets the uniform texture variable for use in shader programs
-        void setUniform(Shader shader, const char* name, GLuint unit);
+        void setUniform(Shader& shader, const char* name, GLuint unit);
 };
 
 #endif
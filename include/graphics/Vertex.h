@@ -13,6 +13,20 @@ struct Vertex {
     glm::vec2 texCoords;
 };
 
+// Block texture coordinates carry their texture array layer in u, as layer * TEXTURE_LAYER_STRIDE + u.
+// u stays below the stride even on LOD faces that repeat a tile, so the shaders can split the two again
+constexpr float TEXTURE_LAYER_STRIDE = 16.0f;
+
+inline int texCoordsLayer(const glm::vec2& texCoords) {
+    return static_cast<int>(texCoords.x / TEXTURE_LAYER_STRIDE);
+}
+
+// Scales the tile part of block texture coordinates, the layer is kept
+inline glm::vec2 scaleTexCoords(const glm::vec2& texCoords, float scale) {
+    const float layerStart = texCoordsLayer(texCoords) * TEXTURE_LAYER_STRIDE;
+    return glm::vec2(layerStart + (texCoords.x - layerStart) * scale, texCoords.y * scale);
+}
+
 struct UniformVertex {
     GLuint data;
 };
@@ -17,12 +17,23 @@ class VertexArrayObject {
         void unbind();
         void deleteBuffers();
 
-        void addVertexBuffer(std::vector<Vertex>& vertices, GLenum usage = GL_STATIC_DRAW);
-        void addElementBuffer(std::vector<GLuint>& indices, GLenum usage = GL_STATIC_DRAW);
+        // A capacity larger than the data leaves room for later updateVertexBuffer/updateElementBuffer calls
+        void addVertexBuffer(std::vector<Vertex>& vertices, GLenum usage = GL_STATIC_DRAW, size_t capacity = 0);
+        void addElementBuffer(std::vector<GLuint>& indices, GLenum usage = GL_STATIC_DRAW, size_t capacity = 0);
         void addAttribute(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer);
 
+        // Rewrites [first, first + count) of the existing buffers in place
+        void updateVertexBuffer(const std::vector<Vertex>& vertices, size_t first, size_t count);
+        void updateElementBuffer(const std::vector<GLuint>& indices, size_t first, size_t count);
+
+        bool isInitialized() const { return VAO != 0; }
+        size_t getVertexCapacity() const { return vertexCapacity; }
+        size_t getElementCapacity() const { return elementCapacity; }
+
     private:
         GLuint VAO, VBO, EBO;
+        size_t vertexCapacity = 0;
+        size_t elementCapacity = 0;
 
 };
 
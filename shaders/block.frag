@@ -1,32 +1,40 @@
 #version 330 core
 
-uniform sampler2D tex0;
-
-uniform vec4 lightColor;
-uniform vec3 fogColor;
-uniform vec3 camPos;
-uniform vec3 foliageColor;
-uniform float fogDensity;
-uniform vec3 lightDir;
-uniform bool useFog;
-uniform float fogStart;
-uniform float fogEnd;
-uniform float fogBottom;
+// Block textures, one layer each
+uniform sampler2DArray tex0;
+
+// Mirrors FrameUniformData in graphics/FrameUniforms.h
+layout(std140) uniform FrameUniforms {
+    mat4 cameraMatrix;
+    vec4 camPos;
+    vec4 lightDir;
+    vec4 lightColor;
+    vec4 fogColor;
+    vec4 fogParams;
+    vec4 foliageColor;
+};
 
 in vec3 normal;
 in vec2 texCoord;
+flat in float texLayer;
 in vec3 curPos;
 in vec3 fragWorldPos;
 
 out vec4 FragColor;
 
 void main() {
-    vec4 texColor = texture(tex0, texCoord);
+    vec4 texColor = texture(tex0, vec3(texCoord, texLayer));
+    // Only the cutout variant alpha tests, so opaque geometry keeps early depth testing
+#ifdef ALPHA_CUTOUT
     if (texColor.a < 0.05)
         discard;
+#endif
 
     // fog
     float distToCam = length(fragWorldPos.xz - camPos.xz); 
+    float fogStart = fogParams.x;
+    float fogEnd = fogParams.y;
+    float fogBottom = fogParams.z;
     float distFog = clamp((fogEnd - distToCam) / (fogEnd - fogStart), 0.0, 1.0);
 
     float fogBottomEnd = fogBottom + 40;
@@ -40,8 +48,8 @@ void main() {
 
     // Lighting
     vec3 N = normalize(normal);
-    vec3 L = normalize(-lightDir);
-    vec3 V = normalize(camPos - curPos);
+    vec3 L = normalize(-lightDir.xyz);
+    vec3 V = normalize(camPos.xyz - curPos);
     vec3 H = normalize(L + V);
 
     float ambient = 0.4;
@@ -59,10 +67,10 @@ void main() {
 
     vec3 finalColor;
 
-    if (useFog) {
-        finalColor = mix(fogColor, litColor, fogFactor);
+    if (fogParams.w > 0.5) {
+        finalColor = mix(fogColor.rgb, litColor, fogFactor);
     } else {
-        finalColor = mix(fogColor, litColor, 1.0);
+        finalColor = mix(fogColor.rgb, litColor, 1.0);
     }
     FragColor = vec4(finalColor, texColor.a);
 }
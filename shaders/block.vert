@@ -3,19 +3,34 @@ layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNorm;
 layout (location = 2) in vec2 aTex;
 
-uniform mat4 cameraMatrix;
+// Mirrors FrameUniformData in graphics/FrameUniforms.h
+layout(std140) uniform FrameUniforms {
+    mat4 cameraMatrix;
+    vec4 camPos;
+    vec4 lightDir;
+    vec4 lightColor;
+    vec4 fogColor;
+    vec4 fogParams;
+    vec4 foliageColor;
+};
+
 uniform mat4 model;
 
 out vec3 normal;
 out vec2 texCoord;
+flat out float texLayer;
 out vec3 fragWorldPos;
 
+// Mirrors TEXTURE_LAYER_STRIDE in graphics/Vertex.h, u holds layer * stride + u
+const float TEXTURE_LAYER_STRIDE = 16.0;
+
 void main()
 {
     vec3 worldPos = vec3(model * vec4(aPos, 1.0));
     fragWorldPos = worldPos;
     normal = aNorm;
-    texCoord = aTex;
+    texLayer = floor(aTex.x / TEXTURE_LAYER_STRIDE);
+    texCoord = vec2(aTex.x - texLayer * TEXTURE_LAYER_STRIDE, aTex.y);
 
     gl_Position = cameraMatrix * vec4(worldPos, 1.0);
 }
@@ -0,0 +1,78 @@
+#version 330 core
+
+// Vertex pulling variant of block.vert. Every face record expands into six vertices picked by gl_VertexID,
+// the record's quad is looked up in the block model table so all block models draw the same as block.vert
+
+// x | y << 4 | z << 8 | quad << 12 | blockID << 16, see ChunkMesher::packFaceRecord
+uniform usamplerBuffer faceRecords;
+// Two texels per model vertex: position.xyz + u, normal.xyz + v
+uniform samplerBuffer modelVertices;
+// First model vertex of every block ID, the top bit marks cross models
+uniform usamplerBuffer blockModels;
+
+// Mirrors FrameUniformData in graphics/FrameUniforms.h
+layout(std140) uniform FrameUniforms {
+    mat4 cameraMatrix;
+    vec4 camPos;
+    vec4 lightDir;
+    vec4 lightColor;
+    vec4 fogColor;
+    vec4 fogParams;
+    vec4 foliageColor;
+};
+
+uniform mat4 model;
+// World position of the chunk's first block
+uniform vec3 chunkOrigin;
+
+out vec3 normal;
+out vec2 texCoord;
+flat out float texLayer;
+out vec3 fragWorldPos;
+
+const int QUAD_CORNERS[6] = int[6](0, 2, 1, 0, 3, 2);
+// Mirrors TEXTURE_LAYER_STRIDE in graphics/Vertex.h, u holds layer * stride + u
+const float TEXTURE_LAYER_STRIDE = 16.0;
+const uint CROSS_MODEL_BIT = 0x80000000u;
+
+// Mirrors crossModelJitter in core/world/ChunkMesher.h
+vec2 crossModelJitter(ivec3 worldPos) {
+    uvec3 p = uvec3(worldPos);
+    uint h = p.x * 73856093u ^ p.y * 19349663u ^ p.z * 83492791u;
+    h ^= h >> 16;
+    h *= 0x7feb352du;
+    h ^= h >> 15;
+    h *= 0x846ca68bu;
+    h ^= h >> 16;
+
+    float offsetX = float(h & 0xFFFFu) / 65535.0;
+    float offsetZ = float(h >> 16) / 65535.0;
+    return vec2(offsetX * 0.5 - 0.25, offsetZ * 0.5 - 0.25);
+}
+
+void main()
+{
+    uint record = texelFetch(faceRecords, gl_VertexID / 6).r;
+    ivec3 local = ivec3(int(record & 15u), int((record >> 4) & 15u), int((record >> 8) & 15u));
+    int quad = int((record >> 12) & 15u);
+    uint blockModel = texelFetch(blockModels, int(record >> 16)).r;
+
+    int vertex = int(blockModel & ~CROSS_MODEL_BIT) + quad * 4 + QUAD_CORNERS[gl_VertexID % 6];
+    vec4 positionU = texelFetch(modelVertices, vertex * 2);
+    vec4 normalV = texelFetch(modelVertices, vertex * 2 + 1);
+
+    vec3 offset = chunkOrigin + vec3(local);
+    if ((blockModel & CROSS_MODEL_BIT) != 0u) {
+        vec2 jitter = crossModelJitter(ivec3(chunkOrigin) + local);
+        offset.x += jitter.x;
+        offset.z += jitter.y;
+    }
+
+    vec3 worldPos = vec3(model * vec4(positionU.xyz + offset, 1.0));
+    fragWorldPos = worldPos;
+    normal = normalV.xyz;
+    texLayer = floor(positionU.w / TEXTURE_LAYER_STRIDE);
+    texCoord = vec2(positionU.w - texLayer * TEXTURE_LAYER_STRIDE, normalV.w);
+
+    gl_Position = cameraMatrix * vec4(worldPos, 1.0);
+}
@@ -1,7 +1,31 @@
 #version 330 core
 
+// Mirrors FrameUniformData in graphics/FrameUniforms.h
+layout(std140) uniform FrameUniforms {
+    mat4 cameraMatrix;
+    vec4 camPos;
+    vec4 lightDir;
+    vec4 lightColor;
+    vec4 fogColor;
+    vec4 fogParams;
+    vec4 foliageColor;
+};
+
+// Horizontal distance at which the clouds have faded out, the edge of the streamed ring
+uniform float fadeEnd;
+
+in vec3 normal;
+in vec3 fragWorldPos;
+
 out vec4 FragColor;
 
 void main() {
-    FragColor = vec4(1.0, 1.0, 1.0, 0.9);
+    // Tops are lit, the sides and bottoms a little darker so the boxes read as volumes
+    float shade = normal.y > 0.0 ? 1.0 : normal.y < 0.0 ? 0.78 : 0.88;
+
+    // Fading out before the ring's edge hides tiles streaming in and out
+    float distToCam = length(fragWorldPos.xz - camPos.xz);
+    float fade = 1.0 - smoothstep(fadeEnd * 0.6, fadeEnd, distToCam);
+
+    FragColor = vec4(vec3(shade) * lightColor.rgb, 0.9 * fade);
 }
@@ -3,9 +3,51 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNorm;
 layout (location = 2) in vec2 aTex;
+// One cloud cell per instance: x | z << 4 | occupied << 8 | covered sides << 9, sides in -X, +X, -Z, +Z order
+layout (location = 3) in uint aCell;
 
-uniform mat4 cameraMatrix;
+// Mirrors FrameUniformData in graphics/FrameUniforms.h
+layout(std140) uniform FrameUniforms {
+    mat4 cameraMatrix;
+    vec4 camPos;
+    vec4 lightDir;
+    vec4 lightColor;
+    vec4 fogColor;
+    vec4 fogParams;
+    vec4 foliageColor;
+};
+
+// Mirrors the constants in core/world/Cloud.h
+const int CLOUD_TILE_COUNT = 25;
+const int CLOUD_CELLS_PER_TILE = 256;
+const float CLOUD_CELL_SIZE = 12.0;
+const float CLOUD_THICKNESS = 4.0;
+const float CLOUD_HEIGHT = 192.0;
+
+// xz origin of the tile in every ring slot, w is 0 while the slot waits for its tile
+uniform vec4 tileOrigins[CLOUD_TILE_COUNT];
+// Distance the whole grid has drifted along X
+uniform float drift;
+
+out vec3 normal;
+out vec3 fragWorldPos;
 
 void main() {
-    gl_Position = cameraMatrix * vec4(aPos, 1.0);
+    vec4 tile = tileOrigins[gl_InstanceID / CLOUD_CELLS_PER_TILE];
+    uint sides = (aCell >> 9) & 15u;
+    bool covered = (aNorm.x < 0.0 && (sides & 1u) != 0u) || (aNorm.x > 0.0 && (sides & 2u) != 0u)
+                || (aNorm.z < 0.0 && (sides & 4u) != 0u) || (aNorm.z > 0.0 && (sides & 8u) != 0u);
+
+    normal = aNorm;
+    // Empty cells, sides against another cell and slots without a tile collapse onto one point outside the clip volume
+    if (tile.w == 0.0 || (aCell & 256u) == 0u || covered) {
+        fragWorldPos = vec3(0.0);
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        return;
+    }
+
+    vec2 cell = vec2(float(aCell & 15u), float((aCell >> 4) & 15u)) * CLOUD_CELL_SIZE;
+    vec3 origin = vec3(tile.x + drift + cell.x, CLOUD_HEIGHT, tile.y + cell.y);
+    fragWorldPos = origin + aPos * vec3(CLOUD_CELL_SIZE, CLOUD_THICKNESS, CLOUD_CELL_SIZE);
+    gl_Position = cameraMatrix * vec4(fragWorldPos, 1.0);
 }
@@ -3,7 +3,17 @@
 layout (location = 0) in vec3 aPos;
 
 uniform mat4 model;
-uniform mat4 cameraMatrix;
+
+// Mirrors FrameUniformData in graphics/FrameUniforms.h
+layout(std140) uniform FrameUniforms {
+    mat4 cameraMatrix;
+    vec4 camPos;
+    vec4 lightDir;
+    vec4 lightColor;
+    vec4 fogColor;
+    vec4 fogParams;
+    vec4 foliageColor;
+};
 
 void main()
 {
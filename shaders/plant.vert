@@ -0,0 +1,78 @@
+#version 330 core
+
+// Instanced plants. Every instance is one plant block, gl_VertexID walks the quads of its model in the
+// block model table and the cross model jitter is worked out here from the block position
+
+// x | y << 4 | z << 8 | blockID << 16, see ChunkMesher::packPlantInstance
+uniform usamplerBuffer plantInstances;
+// Two texels per model vertex: position.xyz + u, normal.xyz + v
+uniform samplerBuffer modelVertices;
+// First model vertex of every block ID, the top bit marks cross models
+uniform usamplerBuffer blockModels;
+
+// Mirrors FrameUniformData in graphics/FrameUniforms.h
+layout(std140) uniform FrameUniforms {
+    mat4 cameraMatrix;
+    vec4 camPos;
+    vec4 lightDir;
+    vec4 lightColor;
+    vec4 fogColor;
+    vec4 fogParams;
+    vec4 foliageColor;
+};
+
+// World position of the chunk's first block
+uniform vec3 chunkOrigin;
+// Instances of earlier plant models in the chunk's instance list, gl_InstanceID restarts at 0 every draw
+uniform int firstInstance;
+
+out vec3 normal;
+out vec2 texCoord;
+flat out float texLayer;
+out vec3 fragWorldPos;
+
+const int QUAD_CORNERS[6] = int[6](0, 2, 1, 0, 3, 2);
+// Mirrors TEXTURE_LAYER_STRIDE in graphics/Vertex.h, u holds layer * stride + u
+const float TEXTURE_LAYER_STRIDE = 16.0;
+const uint CROSS_MODEL_BIT = 0x80000000u;
+
+// Mirrors crossModelJitter in core/world/ChunkMesher.h
+vec2 crossModelJitter(ivec3 worldPos) {
+    uvec3 p = uvec3(worldPos);
+    uint h = p.x * 73856093u ^ p.y * 19349663u ^ p.z * 83492791u;
+    h ^= h >> 16;
+    h *= 0x7feb352du;
+    h ^= h >> 15;
+    h *= 0x846ca68bu;
+    h ^= h >> 16;
+
+    float offsetX = float(h & 0xFFFFu) / 65535.0;
+    float offsetZ = float(h >> 16) / 65535.0;
+    return vec2(offsetX * 0.5 - 0.25, offsetZ * 0.5 - 0.25);
+}
+
+void main()
+{
+    uint instance = texelFetch(plantInstances, firstInstance + gl_InstanceID).r;
+    ivec3 local = ivec3(int(instance & 15u), int((instance >> 4) & 15u), int((instance >> 8) & 15u));
+    uint blockModel = texelFetch(blockModels, int(instance >> 16)).r;
+
+    int vertex = int(blockModel & ~CROSS_MODEL_BIT) + (gl_VertexID / 6) * 4 + QUAD_CORNERS[gl_VertexID % 6];
+    vec4 positionU = texelFetch(modelVertices, vertex * 2);
+    vec4 normalV = texelFetch(modelVertices, vertex * 2 + 1);
+
+    vec3 offset = chunkOrigin + vec3(local);
+    if ((blockModel & CROSS_MODEL_BIT) != 0u) {
+        vec2 jitter = crossModelJitter(ivec3(chunkOrigin) + local);
+        offset.x += jitter.x;
+        offset.z += jitter.y;
+    }
+
+    vec3 worldPos = positionU.xyz + offset;
+    fragWorldPos = worldPos;
+    normal = normalV.xyz;
+    texLayer = floor(positionU.w / TEXTURE_LAYER_STRIDE);
+    texCoord = vec2(positionU.w - texLayer * TEXTURE_LAYER_STRIDE, normalV.w);
+
+    gl_Position = cameraMatrix * vec4(worldPos, 1.0);
+}
@@ -2,8 +2,19 @@
 
 layout(location = 0) in vec3 aPos;
 
-uniform mat4 uMVP;
+// Mirrors FrameUniformData in graphics/FrameUniforms.h
+layout(std140) uniform FrameUniforms {
+    mat4 cameraMatrix;
+    vec4 camPos;
+    vec4 lightDir;
+    vec4 lightColor;
+    vec4 fogColor;
+    vec4 fogParams;
+    vec4 foliageColor;
+};
+
+uniform mat4 model;
 
 void main() {
-    gl_Position = uMVP * vec4(aPos, 1.0);
+    gl_Position = cameraMatrix * model * vec4(aPos, 1.0);
 }
@@ -0,0 +1,187 @@
+#include "core/game/Benchmark.h"
+
+#include "core/game/Game.h"
+#include "core/player/Player.h"
+#include "core/world/PipelineMetrics.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <nlohmann/json.hpp>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+    // Holds over spawn while the first chunks load, then flies out over unloaded terrain in two legs at
+    // a bit above walking flight speed and climbs to look back over the streamed area
+    constexpr float SPAWN_HOLD = 10.0f;
+
+    struct PathPoint {
+        float time;
+        float x, y, z;
+        float yaw;
+        float pitch;
+    };
+
+    constexpr PathPoint PATH[] = {
+        { 0.0f,         8.0f,   150.0f, 8.0f,   -90.0f, -20.0f },
+        { SPAWN_HOLD,   8.0f,   150.0f, 8.0f,   -90.0f, -20.0f },
+        { 14.0f,        8.0f,   150.0f, 8.0f,   0.0f,   -20.0f },
+        { 44.0f,        488.0f, 150.0f, 8.0f,   0.0f,   -20.0f },
+        { 48.0f,        488.0f, 150.0f, 8.0f,   90.0f,  -15.0f },
+        { 68.0f,        488.0f, 130.0f, 328.0f, 90.0f,  -10.0f },
+        { 78.0f,        488.0f, 180.0f, 328.0f, 225.0f, -35.0f },
+    };
+    constexpr size_t PATH_POINTS = sizeof(PATH) / sizeof(PATH[0]);
+
+    // Nearest rank percentile of sorted values
+    float percentile(const std::vector<float>& sorted, float fraction) {
+        if (sorted.empty()) return 0.0f;
+        size_t index = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5f);
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+
+    nlohmann::ordered_json distribution(std::vector<float> values) {
+        std::sort(values.begin(), values.end());
+        double sum = 0.0;
+        for (float value : values) sum += value;
+
+        nlohmann::ordered_json result;
+        result["count"] = values.size();
+        result["mean"] = values.empty() ? 0.0 : sum / values.size();
+        result["p50"] = percentile(values, 0.50f);
+        result["p90"] = percentile(values, 0.90f);
+        result["p95"] = percentile(values, 0.95f);
+        result["p99"] = percentile(values, 0.99f);
+        result["max"] = values.empty() ? 0.0f : values.back();
+        return result;
+    }
+}
+
+Benchmark::Benchmark(const std::string& reportPath) : reportPath(reportPath) {}
+
+void Benchmark::begin(Player& player) {
+    player.setScripted(true);
+    placeOnPath(player, 0.0f);
+
+    const GLubyte* glRenderer = glGetString(GL_RENDERER);
+    renderer = glRenderer ? reinterpret_cast<const char*>(glRenderer) : "unknown";
+
+    PipelineMetrics& metrics = PipelineMetrics::instance();
+    metrics.setTrackingLoadLatency(true);
+    startChunksLoaded = metrics.getChunksLoadedCount();
+    startMeshes = metrics.getMeshCount();
+    startUploadedBytes = metrics.getUploadedMeshBytes();
+
+    frameMilliseconds.reserve(16384);
+    startTime = glfwGetTime();
+    endTime = startTime;
+}
+
+bool Benchmark::update(Player& player, float deltaTime) {
+    pathTime += deltaTime;
+    if (pathTime >= PATH[PATH_POINTS - 1].time) {
+        endTime = glfwGetTime();
+        return false;
+    }
+
+    placeOnPath(player, pathTime);
+    return true;
+}
+
+void Benchmark::recordFrame(float deltaTime, size_t chunkMeshBytes) {
+    frameMilliseconds.push_back(deltaTime * 1000.0f);
+    peakChunkMeshBytes = std::max(peakChunkMeshBytes, chunkMeshBytes);
+}
+
+// The path follows wall clock time, so a slow build covers the same ground in fewer frames
+void Benchmark::placeOnPath(Player& player, float time) {
+    size_t next = 1;
+    while (next < PATH_POINTS - 1 && PATH[next].time <= time) ++next;
+    const PathPoint& from = PATH[next - 1];
+    const PathPoint& to = PATH[next];
+    const float t = std::clamp((time - from.time) / (to.time - from.time), 0.0f, 1.0f);
+
+    // The player position sits below the eye, setPosition adds the eye offset back for the camera
+    glm::vec3 eye = glm::mix(glm::vec3(from.x, from.y, from.z), glm::vec3(to.x, to.y, to.z), t);
+    player.setPosition(eye - glm::vec3(0.0f, player.eyeOffset, 0.0f));
+    player.getCamera().setRotation(glm::mix(from.yaw, to.yaw, t), glm::mix(from.pitch, to.pitch, t));
+}
+
+uint64_t Benchmark::peakProcessMemory() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+    return counters.PeakWorkingSetSize;
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+    return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+bool Benchmark::writeReport() const {
+    using json = nlohmann::ordered_json;
+    const PipelineMetrics& metrics = PipelineMetrics::instance();
+    const double seconds = std::max(endTime - startTime, 1e-6);
+    const Game& game = Game::instance();
+
+    json report;
+    report["version"] = game.getGameVersion();
+    report["renderer"] = renderer;
+    report["seed"] = SEED;
+    report["duration_s"] = seconds;
+
+    json settings;
+    settings["view_distance"] = Player::instance().getViewDistance();
+    settings["chunk_renderer"] = game.getChunkRenderMode() == ChunkRenderMode::VERTEX_PULLING ? "pulling" : "vertex";
+    settings["batch_chunk_draws"] = game.isBatchingChunkDraws();
+    settings["occlusion_queries"] = game.isUsingOcclusionQueries();
+    settings["upload_thread"] = game.isUsingThreadedUploads();
+    settings["instanced_plants"] = game.isUsingInstancedPlants();
+    settings["clouds"] = game.isCloudsEnabled();
+    settings["target_frame_ms"] = game.getTargetFrameTime();
+    report["settings"] = settings;
+
+    json frames = distribution(frameMilliseconds);
+    frames["fps"] = frameMilliseconds.size() / seconds;
+    report["frame_ms"] = frames;
+
+    report["chunk_load_latency_ms"] = distribution(metrics.getLoadLatencies());
+
+    const uint64_t uploadedBytes = metrics.getUploadedMeshBytes() - startUploadedBytes;
+    json streaming;
+    streaming["chunks_generated"] = metrics.getChunksLoadedCount() - startChunksLoaded;
+    streaming["chunks_per_s"] = (metrics.getChunksLoadedCount() - startChunksLoaded) / seconds;
+    streaming["meshes_built"] = metrics.getMeshCount() - startMeshes;
+    streaming["meshes_per_s"] = (metrics.getMeshCount() - startMeshes) / seconds;
+    streaming["mesh_upload_mb"] = uploadedBytes / (1024.0 * 1024.0);
+    streaming["mesh_upload_mb_per_s"] = uploadedBytes / (1024.0 * 1024.0) / seconds;
+    report["streaming"] = streaming;
+
+    json memory;
+    memory["peak_process_mb"] = peakProcessMemory() / (1024.0 * 1024.0);
+    memory["peak_chunk_gpu_mb"] = peakChunkMeshBytes / (1024.0 * 1024.0);
+    report["memory"] = memory;
+
+    std::ofstream file(reportPath);
+    if (!file.is_open()) {
+        std::cerr << "Could not write benchmark report to " << reportPath << std::endl;
+        return false;
+    }
+    file << report.dump(4) << std::endl;
+    std::cout << "Benchmark report written to " << reportPath << std::endl;
+    return true;
+}
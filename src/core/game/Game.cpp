@@ -1,5 +1,6 @@
 #include "core/game/Game.h"
 #include "core/world/World.h"
+#include "core/world/PipelineMetrics.h"
 #include "audio/AudioManager.h"
 #include "core/player/Player.h"
 #include "core/registers/AtlasRegister.h"
@@ -8,6 +9,10 @@
 #include "network/Network.h"
 #include "network/Serializer.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <chrono>
+
 int _fpsCount = 0, fps = 0;
 float prevTime = 0.0f;
 
@@ -21,7 +26,21 @@ std::string Game::fpsCount() {
         _fpsCount = 0;
     }
 
-    return std::string(("TerraLink " + getGameVersion()).c_str()) + "  //  " + std::to_string(fps) + " fps";
+    std::string title = std::string(("TerraLink " + getGameVersion()).c_str()) + "  //  " + std::to_string(fps) + " fps";
+    if (DEV_MODE) {
+        char renderer[128];
+        std::snprintf(renderer, sizeof(renderer), "%s %.1f MB, %d draws%s, %.2fM tris, %.2f ms cpu",
+                      getChunkRenderMode() == ChunkRenderMode::VERTEX_PULLING ? "pulling" : "vertex",
+                      chunkMeshBytes / (1024.0 * 1024.0), chunkDrawCalls,
+                      !batchChunkDraws ? "" : chunkArena->usesIndirectDraws() ? " (indirect)" : " (multi)",
+                      chunkTriangles / 1e6, chunkDrawMilliseconds);
+        std::string culling = chunkCuller.summary();
+        if (occlusionQueries) culling += ", " + std::to_string(chunkQueries.getHiddenCount()) + " hidden by queries";
+        title += "  //  " + std::string(renderer) + "  //  " + culling + "  //  " + chunkArena->summary() + "  //  " + PipelineMetrics::instance().summary();
+        if (quality.isEnabled()) title += "  //  " + quality.summary();
+        if (profiler.isEnabled()) title += "  //  " + profiler.summary();
+    }
+    return title;
 }
 
 Game::Game(GLFWwindow* windowptr, bool devMode) {
@@ -45,30 +64,59 @@ Game::Game(GLFWwindow* windowptr, bool devMode) {
 Game::~Game() {}
 
 void Game::gameLoop() {
-    while (!glfwWindowShouldClose(window)) {
-        deltaTime = static_cast<float>(glfwGetTime() - lastFrame);
-        lastFrame += deltaTime;
-
-        glClearColor(0.38f, 0.66f, 0.77f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    // Frame times are only meaningful without vsync
+    if (benchmark) {
+        glfwSwapInterval(0);
+        benchmark->begin(*player);
+    }
+    lastFrame = glfwGetTime();
 
-        tick();
+    while (!glfwWindowShouldClose(window)) {
+        const double now = glfwGetTime();
+        deltaTime = static_cast<float>(now - lastFrame);
+        lastFrame = now;
+
+        if (benchmark) {
+            if (!benchmark->update(*player, deltaTime)) break;
+            benchmark->recordFrame(deltaTime, chunkMeshBytes);
+        }
+
+        quality.beginFrame();
+        profiler.beginFrame();
+        {
+            FrameProfiler::Scope scope(profiler, "tick", false);
+            simulate(deltaTime);
+            tick();
+        }
+        beginScene();
         render();
-        renderUI();
+        presentScene();
+        {
+            FrameProfiler::Scope scope(profiler, "ui");
+            renderUI();
+        }
+        profiler.endFrame();
+        quality.endFrame(profiler);
+
+        // Chunks past a lowered view distance unload, and come back once it recovers, see World::managerThread
+        if (quality.isEnabled() && quality.getViewDistance() != player->getViewDistance()) {
+            player->syncViewDistance(quality.getViewDistance());
+        }
 
         glfwSwapBuffers(window);
         glfwPollEvents();
         glfwSetWindowTitle(window, fpsCount().c_str());
     }
 
+    const bool reportWritten = !benchmark || benchmark->writeReport();
     shutdown();
 
-    if (!DEV_MODE) {
+    if (!DEV_MODE && !benchmark) {
         std::cout << "Press Enter to exit..." << std::endl;
         std::cin.ignore();  
     }
 
-    exit(0);
+    exit(reportWritten ? 0 : 1);
     return;
 }
 
@@ -76,16 +124,20 @@ void Game::loadAssets() {
     
     Atlas blockAtlas((Game::instance().getBasePath() + "/assets/textures/blocks/").c_str());
     blockRegister = std::make_unique<BlockRegister>();
+    blockRegister->setInstancedPlants(instancedPlants);
     blockAtlas.linkBlocksToAtlas(blockRegister.get());
     BlockRegister::setInstance(blockRegister.get());
+    uploadBlockModels();
 
-    atlas = std::make_unique<Texture>(
-        (getBasePath() + "/assets/textures/blocks/block_atlas.png").c_str(),
-        GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE,
-        GL_NEAREST, GL_CLAMP_TO_BORDER
-    );
+    atlas = blockAtlas.createTexture(0);
     shaderProgram->use();
     atlas->setUniform(*shaderProgram, "tex0", 0);
+    cutoutShaderProgram->use();
+    atlas->setUniform(*cutoutShaderProgram, "tex0", 0);
+    pullingShaderProgram->use();
+    atlas->setUniform(*pullingShaderProgram, "tex0", 0);
+    pullingCutoutShaderProgram->use();
+    atlas->setUniform(*pullingCutoutShaderProgram, "tex0", 0);
 
     crosshairTex = std::make_unique<Texture>(
         (getBasePath() + "/assets/textures/ui/crosshair.png").c_str(),
@@ -138,6 +190,8 @@ void Game::loadAssets() {
     wireFrameVAO->addAttribute(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
     wireFrameVAO->unbind();
 
+    chunkQueries.init();
+
     AudioManager::setMusicVolume(musicVolume);
     AudioManager::setSoundVolume(soundVolume);
     AudioManager::init();
@@ -150,16 +204,46 @@ void Game::setupShadersAndUniforms() {
         getBasePath() + "/shaders/block.frag"
     );
 
-    shaderProgram->use();
-    shaderProgram->setUniform3("lightDir", glm::normalize(glm::vec3(-1.0f, -1.0f, -0.3f)));
-    shaderProgram->setUniform4("lightColor", glm::vec4(1.0f));
-    shaderProgram->setUniform3("fogColor", glm::vec3(0.38f, 0.66f, 0.77f));
-    shaderProgram->setFloat("fogDensity", 0.015f);
-    shaderProgram->setUniform3("foliageColor", glm::vec3(0.3f, 0.7f, 0.2f));
-    shaderProgram->setInt("useFog", isFogEnabled() ? 1 : 0);
-    shaderProgram->setFloat("fogStart", Player::instance().getNearFogDistance());
-    shaderProgram->setFloat("fogEnd", Player::instance().getFarFogDistance());
-    shaderProgram->setFloat("fogBottom", Player::instance().getBottomFogDistance());
+    // Same block shader with alpha testing, only used for the cutout part of chunk meshes
+    cutoutShaderProgram = std::make_unique<Shader>(
+        getBasePath() + "/shaders/block.vert",
+        getBasePath() + "/shaders/block.frag",
+        std::vector<std::string>{ "ALPHA_CUTOUT" }
+    );
+
+    // Vertex pulling variants, they share the fragment shader so both renderers look identical
+    pullingShaderProgram = std::make_unique<Shader>(
+        getBasePath() + "/shaders/block_pulling.vert",
+        getBasePath() + "/shaders/block.frag"
+    );
+    pullingCutoutShaderProgram = std::make_unique<Shader>(
+        getBasePath() + "/shaders/block_pulling.vert",
+        getBasePath() + "/shaders/block.frag",
+        std::vector<std::string>{ "ALPHA_CUTOUT" }
+    );
+
+    for (Shader* pullingShader : { pullingShaderProgram.get(), pullingCutoutShaderProgram.get() }) {
+        pullingShader->use();
+        pullingShader->setInt("faceRecords", 1);
+        pullingShader->setInt("modelVertices", 2);
+        pullingShader->setInt("blockModels", 3);
+    }
+
+    // Plants read the same model tables, with each chunk's plant instances in place of the face records
+    plantShaderProgram = std::make_unique<Shader>(
+        getBasePath() + "/shaders/plant.vert",
+        getBasePath() + "/shaders/block.frag",
+        std::vector<std::string>{ "ALPHA_CUTOUT" }
+    );
+    plantShaderProgram->use();
+    plantShaderProgram->setInt("plantInstances", 1);
+    plantShaderProgram->setInt("modelVertices", 2);
+    plantShaderProgram->setInt("blockModels", 3);
+
+    cloudShaderProgram = std::make_unique<Shader>(
+        getBasePath() + "/shaders/cloud.vert",
+        getBasePath() + "/shaders/cloud.frag"
+    );
 
     uiShaderProgram = std::make_unique<Shader>(
         getBasePath() + "/shaders/ui.vert",
@@ -171,6 +255,14 @@ void Game::setupShadersAndUniforms() {
         getBasePath() + "/shaders/wireframe.frag"
     );
 
+    // Camera, light and fog come from one uniform buffer written at the start of every frame
+    frameUniforms.init();
+    for (Shader* shader : { shaderProgram.get(), cutoutShaderProgram.get(), pullingShaderProgram.get(),
+                            pullingCutoutShaderProgram.get(), plantShaderProgram.get(), cloudShaderProgram.get(),
+                            wireFrameShaderProgram.get() }) {
+        shader->bindUniformBlock(FrameUniformBuffer::BLOCK_NAME, FrameUniformBuffer::BINDING);
+    }
+
     glEnable(GL_DEPTH_TEST);
     glEnable(GL_CULL_FACE);
 }
@@ -189,6 +281,49 @@ Game& Game::instance() {
     return *s_instance;
 }
 
+// Uploads the mesher's block model table as buffer textures for the vertex pulling shader
+void Game::uploadBlockModels() {
+    const BlockMeshTable& table = blockRegister->getMeshTable();
+    if (!table.fitsFaceRecords) {
+        std::cerr << "Block models do not fit in face records, chunks will use vertex buffers" << std::endl;
+    }
+
+    std::vector<glm::vec4> modelVertices;
+    modelVertices.reserve(table.vertices.size() * 2);
+    for (const Vertex& vertex : table.vertices) {
+        modelVertices.emplace_back(vertex.position, vertex.texCoords.x);
+        modelVertices.emplace_back(vertex.normal, vertex.texCoords.y);
+    }
+
+    constexpr uint32_t CROSS_MODEL_BIT = 1u << 31;
+    std::vector<uint32_t> blockModels(table.blocks.size());
+    for (size_t i = 0; i < table.blocks.size(); ++i) {
+        blockModels[i] = table.blocks[i].firstVertex | (table.blocks[i].model == BlockModel::CROSS ? CROSS_MODEL_BIT : 0);
+    }
+
+    if (!modelVertices.empty()) modelVertexBuffer.upload(modelVertices.data(), modelVertices.size() * sizeof(glm::vec4), GL_RGBA32F);
+    if (!blockModels.empty()) blockModelBuffer.upload(blockModels.data(), blockModels.size() * sizeof(uint32_t), GL_R32UI);
+
+    // Core profile needs a bound VAO even when the shader reads no attributes
+    pullingVAO = std::make_unique<VertexArrayObject>();
+    pullingVAO->init();
+}
+
+void Game::toggleChunkRenderMode() {
+    setChunkRenderMode(getChunkRenderMode() == ChunkRenderMode::VERTEX_PULLING ? ChunkRenderMode::VERTEX_BUFFERS : ChunkRenderMode::VERTEX_PULLING);
+    std::cout << "Chunk renderer: " << (getChunkRenderMode() == ChunkRenderMode::VERTEX_PULLING ? "vertex pulling" : "vertex buffers") << std::endl;
+    getWorld().remeshUploadedChunks();
+}
+
+// Picks the coarsest level of detail whose distance ring contains the chunk
+int Game::getLodLevelForDistance(int chunkDistance) const {
+    for (int lodLevel = 2; lodLevel >= 1; --lodLevel) {
+        int distance = getLodDistance(lodLevel);
+        if (distance > 0 && chunkDistance >= distance) return lodLevel;
+    }
+    return 0;
+}
+
 std::string Game::getBasePath() const {
     return basePath.string();
 }
@@ -200,14 +335,34 @@ std::string Game::getSavePath() const {
 void Game::init() {
 
     GameInit::parseGameSettings((basePath.string() + "/game.settings").c_str());
+    glfwSwapInterval(vsync ? 1 : 0);
+    quality.setMaxViewDistance(player->getViewDistance());
+
+    // Benchmarks start over on their own save every run, so they always generate the same chunks
+    if (benchmark) {
+        setWorldSave(Benchmark::SAVE_NAME);
+        std::error_code error;
+        std::filesystem::remove_all(savePath / Benchmark::SAVE_NAME, error);
+    }
 
     setupShadersAndUniforms();
     loadAssets();
 
+    if (profiler.isEnabled() && !profiler.openLog((basePath / "frame_profile.csv").string())) {
+        std::cerr << "Could not open frame_profile.csv, frame timings are only shown in the title" << std::endl;
+    }
+    // The quality controller reads the GPU time of the render passes from the profiler's queries
+    if (quality.isEnabled()) profiler.setEnabled(true);
+
+    chunkArena = std::make_unique<ChunkBufferArena>();
+    ChunkBufferArena::setInstance(chunkArena.get());
+
     world = std::make_unique<World>();
     World::setInstance(world.get());
+    if (benchmark) world->setSeed(Benchmark::SEED);
 
     world->init();
+    if (threadedUploads) world->startUploadThread(window);
     world->setSaveDirectory(getWorldSave());
     if (!NetworkManager::instance().isOnlineMode()) world->createSaveDirectory();
 
@@ -218,39 +373,248 @@ void Game::init() {
     // }
 
     world->loadPlayerData(*player, player->getPlayerName());
+    if (cloudsEnabled) world->clouds.start(static_cast<int>(world->getSeed()));
+}
+
+// Runs the simulation in fixed steps for the time that has passed, whatever the frame rate.
+// After a long stall the steps are capped and the rest of the time dropped, so catching up never takes longer
+// than the stall did. The time left over is carried to the next frame and used to interpolate the camera
+void Game::simulate(float frameSeconds) {
+    simulationTime += frameSeconds;
+    int steps = 0;
+    while (simulationTime >= SIMULATION_STEP && steps < MAX_SIMULATION_STEPS) {
+        Player::instance().simulate(SIMULATION_STEP);
+        simulationTime -= SIMULATION_STEP;
+        ++steps;
+    }
+    if (steps == MAX_SIMULATION_STEPS) simulationTime = std::min(simulationTime, SIMULATION_STEP);
 }
 
 void Game::tick() {
     getWorld().uploadChunkMeshes(15);
+    getWorld().updateChunkLods();
+    getWorld().processBorderRemeshes();
     getWorld().unloadDistantChunks();
     getWorld().uploadChunksToMap();
+    chunkArena->defragment();
 }
 
-void Game::render() {
-    Player::instance().update(deltaTime);
+// Binds the framebuffer the world is drawn into and clears it. While the quality controller has lowered the
+// render scale that is sceneTarget at the scaled size, otherwise the window's own framebuffer
+void Game::beginScene() {
+    glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+    const float scale = quality.getRenderScale();
+    sceneScaled = scale < 1.0f && framebufferWidth > 0 && framebufferHeight > 0
+        && sceneTarget.resize(std::max(1, static_cast<int>(framebufferWidth * scale)),
+                              std::max(1, static_cast<int>(framebufferHeight * scale)));
+
+    if (sceneScaled) {
+        sceneTarget.bind();
+    } else {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, framebufferWidth, framebufferHeight);
+    }
 
-    shaderProgram->use();
+    glClearColor(0.38f, 0.66f, 0.77f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+// Upscales a scaled scene over the window, the UI is drawn on top at full resolution
+void Game::presentScene() {
+    if (!sceneScaled) return;
+    FrameProfiler::Scope scope(profiler, "upscale");
+    sceneTarget.blitToScreen(framebufferWidth, framebufferHeight);
+}
+
+// Writes the values every world shader shares for this frame
+void Game::updateFrameUniforms() {
+    const Camera& camera = Player::instance().getCamera();
+
+    FrameUniformData data;
+    data.cameraMatrix = camera.cameraMatrix;
+    data.camPos = glm::vec4(camera.position, 1.0f);
+    data.lightDir = glm::vec4(glm::normalize(glm::vec3(-1.0f, -1.0f, -0.3f)), 0.0f);
+    data.lightColor = glm::vec4(1.0f);
+    data.fogColor = glm::vec4(0.38f, 0.66f, 0.77f, 0.015f);
+    data.fogParams = glm::vec4(Player::instance().getNearFogDistance(), Player::instance().getFarFogDistance(),
+                               Player::instance().getBottomFogDistance(), isFogEnabled() ? 1.0f : 0.0f);
+    data.foliageColor = glm::vec4(0.3f, 0.7f, 0.2f, 1.0f);
+    frameUniforms.update(data);
+}
+
+void Game::render() {
+    Player::instance().update(deltaTime, simulationTime / SIMULATION_STEP);
+    updateFrameUniforms();
 
-    shaderProgram->setUniform4("cameraMatrix", Player::instance().getCamera().cameraMatrix);
-    shaderProgram->setUniform3("camPos", Player::instance().getCamera().position);
     atlas->bind();
 
-    for (auto& [pos, chunk] : world->chunks) {
-        if (!chunk->mesh.isUploaded || chunk->mesh.vertices.empty() || chunk->mesh.indices.empty()) continue;
-        chunk->mesh.VAO.bind();
-        glm::mat4 model = glm::mat4(1.0f);
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram->ID, "model"), 1, GL_FALSE, glm::value_ptr(model));
-        glDrawElements(GL_TRIANGLES, chunk->mesh.indices.size(), GL_UNSIGNED_INT, 0);
+    modelVertexBuffer.bind(2);
+    blockModelBuffer.bind(3);
+    glActiveTexture(GL_TEXTURE0);
+
+    chunkMeshBytes = 0;
+    for (const ChunkDrawRecord& record : world->renderList.getRecords()) {
+        chunkMeshBytes += record.chunk->mesh.getGpuBytes();
+    }
+
+    // Ended before the outline section begins, GPU sections cannot nest
+    const int chunkSection = profiler.beginSection("chunks", true);
+    auto drawStart = std::chrono::steady_clock::now();
+    const Camera& camera = Player::instance().getCamera();
+    chunkCuller.setViewRadius(static_cast<float>(Player::instance().getFarFogDistance()));
+    chunkCuller.cull(world->renderList, world->chunks, camera.cameraMatrix, camera.position, visibleChunks);
+
+    // Occlusion queries hold back chunks that were hidden last frame, and pick a few visible ones to retest
+    std::vector<const ChunkDrawRecord*>* drawChunks = &visibleChunks;
+    if (occlusionQueries) {
+        chunkQueries.beginFrame(visibleChunks, camera.position, unqueriedChunks, queriedChunks);
+        drawChunks = &unqueriedChunks;
+    } else {
+        queriedChunks.clear();
+    }
+
+    // Opaque geometry first without discard so early depth testing rejects hidden fragments,
+    // then the alpha tested rest of every mesh on top. Each pass draws the vertex buffer chunks,
+    // then the chunks uploaded as face records, both front to back in the order the culler left them
+    chunkDrawCalls = 0;
+    chunkTriangles = 0;
+    ChunkBufferArena& arena = *chunkArena;
+    for (int pass = 0; pass < 2; ++pass) {
+        const bool cutoutPass = pass == 1;
+        Shader* vertexShader = cutoutPass ? cutoutShaderProgram.get() : shaderProgram.get();
+        Shader* pullingShader = cutoutPass ? pullingCutoutShaderProgram.get() : pullingShaderProgram.get();
+
+        for (Shader* blockShader : { vertexShader, pullingShader }) {
+            const bool pulling = blockShader == pullingShader;
+
+            blockShader->use();
+            blockShader->setMat4(blockShader->getUniformLocation("model"), glm::mat4(1.0f));
+            const GLint chunkOriginLocation = blockShader->getUniformLocation("chunkOrigin");
+            if (pulling) pullingVAO->bind();
+            const bool batched = !pulling && batchChunkDraws;
+            if (batched) arena.beginBatch();
+
+            for (const ChunkDrawRecord* record : *drawChunks) {
+                if (record->pulling != pulling) continue;
+                drawChunk(*record, chunkOriginLocation, cutoutPass, batched);
+            }
+            if (batched) chunkDrawCalls += arena.drawBatch();
+
+            // Queried chunks are drawn one by one, each inside its own query
+            for (const ChunkDrawRecord* record : queriedChunks) {
+                if (record->pulling != pulling) continue;
+                chunkQueries.beginChunkQuery(record->position, pass);
+                drawChunk(*record, chunkOriginLocation, cutoutPass, false);
+                chunkQueries.endChunkQuery();
+            }
+            if (!pulling) arena.unbind();
+        }
+
+        // Hidden chunks are tested against the opaque depth only, cutout faces do not cover anything reliably
+        if (!cutoutPass && occlusionQueries) chunkQueries.queryHiddenChunks(*wireFrameShaderProgram);
+    }
+
+    // Plants last, they are alpha tested like the cutout pass and only need the model tables
+    if (blockRegister->getMeshTable().instancedPlants) {
+        plantShaderProgram->use();
+        const GLint chunkOriginLocation = plantShaderProgram->getUniformLocation("chunkOrigin");
+        const GLint firstInstanceLocation = plantShaderProgram->getUniformLocation("firstInstance");
+        pullingVAO->bind();
+        for (const auto* records : { drawChunks, &queriedChunks }) {
+            for (const ChunkDrawRecord* record : *records) {
+                if (record->hasPlants) drawPlants(*record, chunkOriginLocation, firstInstanceLocation);
+            }
+        }
+    }
+    glActiveTexture(GL_TEXTURE0);
+    chunkDrawMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - drawStart).count();
+    profiler.endSection(chunkSection);
+
+    // After the chunks so depth testing hides the clouds behind terrain, blended so they go last
+    {
+        FrameProfiler::Scope cloudScope(profiler, "clouds");
+        world->updateCloudsAroundPlayer();
+        world->drawClouds(*cloudShaderProgram);
     }
 
     AudioManager::update(deltaTime);
+    FrameProfiler::Scope outlineScope(profiler, "outline");
     renderBlockOutline();
 }
 
+// Draws the opaque or cutout part of one chunk with the bound block shader, or queues it in the arena batch.
+// chunkOriginLocation is the vertex pulling shader's chunkOrigin uniform
+void Game::drawChunk(const ChunkDrawRecord& record, GLint chunkOriginLocation, bool cutoutPass, bool batched) {
+    const size_t first = cutoutPass ? record.opaqueCount : 0;
+    const size_t count = cutoutPass ? record.cutoutCount : record.opaqueCount;
+    if (count == 0) return;
+
+    if (record.pulling) {
+        const ChunkPosition& pos = record.position;
+        record.chunk->mesh.faceRecordBuffer.bind(1);
+        glUniform3f(chunkOriginLocation, pos.x * (float)CHUNK_SIZE, pos.y * (float)CHUNK_SIZE, pos.z * (float)CHUNK_SIZE);
+        glDrawArrays(GL_TRIANGLES, first * 6, count * 6);
+        ++chunkDrawCalls;
+        chunkTriangles += count * 2;
+        return;
+    }
+
+    ChunkBufferArena& arena = *chunkArena;
+    if (!arena.isValid(record.arenaHandle)) return;
+
+    chunkTriangles += count / 3;
+    if (batched) {
+        arena.addDraw(record.arenaHandle, first, count);
+        return;
+    }
+
+    // Chunks in the same page share a VAO, so it is only rebound when the page changes
+    const ArenaAllocation& allocation = arena.get(record.arenaHandle);
+    arena.bindPage(allocation.page);
+    glDrawElementsBaseVertex(GL_TRIANGLES, count, GL_UNSIGNED_INT,
+                             (void*)((allocation.firstIndex + first) * sizeof(GLuint)), allocation.firstVertex);
+    ++chunkDrawCalls;
+}
+
+// Draws every plant model of one chunk with one instanced draw, the model's quads come from the block model table
+void Game::drawPlants(const ChunkDrawRecord& record, GLint chunkOriginLocation, GLint firstInstanceLocation) {
+    const PlantInstanceCounts& counts = record.plantCounts;
+    const std::array<uint32_t, PLANT_MODEL_COUNT>& modelQuads = blockRegister->getMeshTable().plantModelQuads;
+    const ChunkPosition& pos = record.position;
+
+    record.chunk->mesh.plantInstanceBuffer.bind(1);
+    glUniform3f(chunkOriginLocation, pos.x * (float)CHUNK_SIZE, pos.y * (float)CHUNK_SIZE, pos.z * (float)CHUNK_SIZE);
+
+    GLint firstInstance = 0;
+    for (int model = 0; model < PLANT_MODEL_COUNT; ++model) {
+        if (counts[model] == 0) continue;
+        glUniform1i(firstInstanceLocation, firstInstance);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, modelQuads[model] * 6, counts[model]);
+        firstInstance += counts[model];
+        ++chunkDrawCalls;
+        chunkTriangles += static_cast<size_t>(counts[model]) * modelQuads[model] * 2;
+    }
+}
+
 void Game::shutdown() {
+    world->stopUploadThread();
     atlas->deleteTexture();
     crosshairTex->deleteTexture();
     shaderProgram->deleteShader();
+    cutoutShaderProgram->deleteShader();
+    pullingShaderProgram->deleteShader();
+    pullingCutoutShaderProgram->deleteShader();
+    plantShaderProgram->deleteShader();
+    cloudShaderProgram->deleteShader();
+    world->clouds.stop();
+    modelVertexBuffer.deleteBuffers();
+    blockModelBuffer.deleteBuffers();
+    pullingVAO->deleteBuffers();
+    chunkArena->deleteBuffers();
+    chunkQueries.deleteBuffers();
+    profiler.deleteQueries();
+    sceneTarget.deleteBuffers();
+    frameUniforms.deleteBuffers();
     uiShaderProgram->deleteShader();
     wireFrameShaderProgram->deleteShader();
     AudioManager::shutdown();
@@ -310,10 +674,9 @@ void Game::renderBlockOutline() {
 
     glm::mat4 model = glm::translate(glm::mat4(1.0f), pos - glm::vec3(0.001f));
     model = glm::scale(model, glm::vec3(1.002f));
-    glm::mat4 mvp = Player::instance().getCamera().cameraMatrix * model;
 
     wireFrameShaderProgram->use();
-    wireFrameShaderProgram->setMat4("uMVP", mvp);
+    wireFrameShaderProgram->setMat4("model", model);
 
     wireFrameVAO->bind();
     glDrawElements(GL_LINES, 24, GL_UNSIGNED_INT, 0);
@@ -53,6 +53,33 @@ namespace GameInit {
                 Game::instance().setWorldSave(value);
             } else if (key == "seed") {
                 World::instance().setSeed(std::stoi(value));
+            } else if (key == "lod1Distance" || key == "lod2Distance") {
+                int lodDistance = std::stoi(value);
+                if (lodDistance < 0) lodDistance = 0;
+                if (lodDistance > 64) lodDistance = 64;
+                Game::instance().setLodDistance(key == "lod1Distance" ? 1 : 2, lodDistance);
+            } else if (key == "chunkRenderer") {
+                Game::instance().setChunkRenderMode(value == "pulling" ? ChunkRenderMode::VERTEX_PULLING : ChunkRenderMode::VERTEX_BUFFERS);
+            } else if (key == "occlusionCulling") {
+                Game::instance().setOcclusionCulling(value == "true" || value == "1");
+            } else if (key == "occlusionQueries") {
+                Game::instance().setOcclusionQueries(value == "true" || value == "1");
+            } else if (key == "batchChunkDraws") {
+                Game::instance().setBatchChunkDraws(value == "true" || value == "1");
+            } else if (key == "uploadThread") {
+                Game::instance().setThreadedUploads(value == "true" || value == "1");
+            } else if (key == "instancedPlants") {
+                Game::instance().setInstancedPlants(value == "true" || value == "1");
+            } else if (key == "clouds") {
+                Game::instance().setCloudsEnabled(value == "true" || value == "1");
+            } else if (key == "frameProfiler") {
+                Game::instance().setFrameProfiler(value == "true" || value == "1");
+            } else if (key == "vsync") {
+                Game::instance().setVsync(value == "true" || value == "1");
+            } else if (key == "targetFrameTime") {
+                float targetFrameTime = std::stof(value);
+                if (targetFrameTime < 0.0f) targetFrameTime = 0.0f;
+                Game::instance().setTargetFrameTime(targetFrameTime);
             } else if (key == "distanceFog") {
                 Game::instance().setEnableFog(value == "true" || value == "1");
             } else if (key == "musicVolume") {
@@ -0,0 +1,66 @@
+#include "core/game/QualityController.h"
+
+#include "graphics/FrameProfiler.h"
+
+#include <algorithm>
+#include <cstdio>
+
+void QualityController::setMaxViewDistance(int distance) {
+    maxViewDistance = distance;
+    viewDistance = distance;
+}
+
+void QualityController::beginFrame() {
+    if (!isEnabled()) return;
+    frameStart = std::chrono::steady_clock::now();
+}
+
+void QualityController::endFrame(const FrameProfiler& profiler) {
+    if (!isEnabled()) return;
+
+    cpuSum += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - frameStart).count();
+    if (++windowFrames < WINDOW_FRAMES) return;
+
+    cpuMilliseconds = cpuSum / windowFrames;
+    gpuMilliseconds = profiler.recentGpuMilliseconds(WINDOW_FRAMES);
+    windowFrames = 0;
+    cpuSum = 0.0f;
+    adjust();
+}
+
+// The GPU time only covers the queries' busy time, not the gaps where the GPU waits for the CPU, so a frame is
+// only blamed on the GPU when that time clearly exceeds the CPU's. Lowering the resolution does nothing for
+// a CPU bound frame, those go straight to the view distance
+void QualityController::adjust() {
+    const auto now = std::chrono::steady_clock::now();
+    const bool settled = now >= settleUntil;
+    const int minViewDistance = std::min(MIN_VIEW_DISTANCE, maxViewDistance);
+    const float frameMilliseconds = std::max(cpuMilliseconds, gpuMilliseconds);
+    const bool gpuBound = gpuMilliseconds > cpuMilliseconds * GPU_BOUND_RATIO;
+    const auto settle = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<float>(VIEW_DISTANCE_SETTLE_SECONDS));
+
+    if (frameMilliseconds > targetMilliseconds) {
+        if (gpuBound && renderScale > MIN_RENDER_SCALE) {
+            renderScale = std::max(MIN_RENDER_SCALE, renderScale - RENDER_SCALE_STEP);
+        } else if (settled && viewDistance > minViewDistance) {
+            --viewDistance;
+            settleUntil = now + settle;
+        }
+    } else if (frameMilliseconds < targetMilliseconds * RECOVER_FRACTION) {
+        if (renderScale < 1.0f) {
+            renderScale = std::min(1.0f, renderScale + RENDER_SCALE_STEP);
+        } else if (settled && viewDistance < maxViewDistance) {
+            ++viewDistance;
+            settleUntil = now + settle;
+        }
+    }
+}
+
+std::string QualityController::summary() const {
+    char text[128];
+    std::snprintf(text, sizeof(text), "quality %d%% res, view %d/%d, %.1f ms cpu %.1f ms gpu / %.1f ms target",
+                  static_cast<int>(renderScale * 100.0f + 0.5f), viewDistance, maxViewDistance,
+                  cpuMilliseconds, gpuMilliseconds, targetMilliseconds);
+    return text;
+}
@@ -48,7 +48,7 @@ void Camera::setRotation(float yaw, float pitch) {
 
 // Sets the camera matrix in the shader program
 void Camera::matrix(Shader& shaderProgram, const char* uniformName) {
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram.ID, uniformName), 1, GL_FALSE, glm::value_ptr(cameraMatrix));
+    shaderProgram.setMat4(uniformName, cameraMatrix);
 }
 
 // Updates the camera matrix based on the window size and projection type
@@ -1,6 +1,7 @@
 #include "core/player/Player.h"
 
 #include "audio/AudioManager.h"
+#include "core/game/Game.h"
 
 Player* Player::s_instance = nullptr;
 
@@ -18,7 +19,7 @@ Player& Player::instance() {
     return *s_instance;
 }
 
-Player::Player(GLFWwindow* window) : playerPosition(5.0f, 90.0f, 3.0f), camera(glm::vec3(5.0f, 130.0f + eyeOffset, 3.0f)) {
+Player::Player(GLFWwindow* window) : playerPosition(5.0f, 90.0f, 3.0f), previousPosition(playerPosition), camera(glm::vec3(5.0f, 130.0f + eyeOffset, 3.0f)) {
     camera.updateCameraMatrix(0.1f, getRenderDistance(), window);
     this->window = window;
     glfwSetScrollCallback(window, scrollCallback);
@@ -64,20 +65,16 @@ void Player::moveWithCollision(glm::vec3 velocity, float deltaTime) {
 #undef max
 #include <algorithm>
 
-// Updates the player's position and camera based on input
-void Player::update(float deltaTime) {
-    jumpBufferTime -= deltaTime;
-    jumpCooldown -= deltaTime;
+// Advances movement and physics by one fixed simulation step, see Game::SIMULATION_STEP
+void Player::simulate(float step) {
+    if (scripted) return;
+    previousPosition = playerPosition;
+
+    jumpBufferTime -= step;
+    jumpCooldown -= step;
     jumpBufferTime = std::max(0.0f, jumpBufferTime);
     jumpCooldown = std::max(0.0f, jumpCooldown);
 
-    int width, height;
-    glfwGetFramebufferSize(window, &width, &height);
-    if (width == 0 || height == 0) {
-        return;
-    }
-
-    camera.updateCameraMatrix(0.1f, getRenderDistance(), window);
     if (gameMode == 0) {
         glm::vec3 groundCheck = playerPosition;
         groundCheck.y -= 0.15f;
@@ -97,11 +94,11 @@ void Player::update(float deltaTime) {
         if (!onGround && !glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS) {
             const float gravity = -20.f;
             const float terminalVelocity = -75.0f;
-            verticalVelocity = std::max(verticalVelocity + gravity * deltaTime, terminalVelocity);
+            verticalVelocity = std::max(verticalVelocity + gravity * step, terminalVelocity);
         }
 
         glm::vec3 before = playerPosition;
-        moveWithCollision(glm::vec3(0.0f, verticalVelocity, 0.0f), deltaTime);
+        moveWithCollision(glm::vec3(0.0f, verticalVelocity, 0.0f), step);
         glm::vec3 after = playerPosition;
 
         if (verticalVelocity > 0.0f && after.y <= before.y + 0.001f) {
@@ -109,6 +106,20 @@ void Player::update(float deltaTime) {
         }
     }
 
+    handleMovementInput(step);
+}
+
+// Updates the camera once per rendered frame. The camera sits between the last two simulation steps,
+// interpolation is how far the frame is into the next step, and looking around is not held to the step
+void Player::update(float deltaTime, float interpolation) {
+    int width, height;
+    glfwGetFramebufferSize(window, &width, &height);
+    if (width == 0 || height == 0) {
+        return;
+    }
+
+    camera.position = glm::mix(previousPosition, playerPosition, interpolation) + glm::vec3(0.0f, eyeOffset, 0.0f);
+
     if (auto hit = camera.raycastToBlock(World::instance())) {
         highlightedBlock = hit->block;
         highlightedNormal = hit->normal;
@@ -117,18 +128,21 @@ void Player::update(float deltaTime) {
         highlightedNormal = glm::ivec3(0);
     }
 
-    handleInput(deltaTime);
+    if (!scripted) handleInput(deltaTime);
+    camera.updateCameraMatrix(0.1f, getRenderDistance(), window);
 }
 
 // Sets the player's position using x, y, z coordinates
 void Player::setPosition(float x, float y, float z) {
     playerPosition = glm::vec3(x, y, z);
+    previousPosition = playerPosition;
     camera.position = playerPosition + glm::vec3(0.0f, eyeOffset, 0.0f);
 }
 
 // Sets the player's position using a glm::vec3 object
 void Player::setPosition(const glm::vec3& pos) {
     playerPosition = pos;
+    previousPosition = playerPosition;
     camera.position = playerPosition + glm::vec3(0.0f, eyeOffset, 0.0f);
 }
 
@@ -162,9 +176,12 @@ std::string Player::getPlayerName() {
     return playerName;
 }
 
-// Handles input for the player, including movement and camera rotation
-void Player::handleInput(float deltaTime) {
+// Moves the player from the held movement keys, run once per simulation step.
+// Flying moves the camera, so it is put at the simulated position first and the result copied back
+void Player::handleMovementInput(float deltaTime) {
     if (gameMode == 1) {
+        camera.position = playerPosition + glm::vec3(0.0f, eyeOffset, 0.0f);
+
         if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) {
             camera.updatePosition(CAM_FORWARD, deltaTime);
         }
@@ -190,6 +207,7 @@ void Player::handleInput(float deltaTime) {
         if (glfwGetKey(window, GLFW_KEY_LEFT_CONTROL) == GLFW_RELEASE) {
             camera.movementSpeed = 5.25f;
         }
+        playerPosition = camera.position - glm::vec3(0.0f, eyeOffset, 0.0f);
     } else if (gameMode == 0) {
 
         bool isSprinting = glfwGetKey(window, GLFW_KEY_LEFT_CONTROL) == GLFW_PRESS;
@@ -287,7 +305,10 @@ void Player::handleInput(float deltaTime) {
             lastFootstepPos = playerPosition;
         }
     }
+}
 
+// Handles the rest of the input once per frame: looking around, mode and window keys, and block clicks
+void Player::handleInput(float deltaTime) {
     static bool lastNPress = false;
     if (glfwGetKey(window, GLFW_KEY_N) == GLFW_PRESS && !lastNPress) {
         gameMode = gameMode == 0 ? 1 : 0;
@@ -395,10 +416,6 @@ void Player::handleInput(float deltaTime) {
     }
     lastMiddleClick = middleNow;
 
-    if (gameMode == 1) {
-        playerPosition = camera.position - glm::vec3(0.0f, eyeOffset, 0.0f);
-    }
-
     static bool lastF3 = false;
     static bool lastR = false;
     bool f3Down = glfwGetKey(window, GLFW_KEY_F3) == GLFW_PRESS;
@@ -409,8 +426,15 @@ void Player::handleInput(float deltaTime) {
         std::cout << "[DEBUG] F3 + R pressed: Reloading chunks around player\n";
         // World::instance().needsFullReset = true;
     }
+    static bool lastV = false;
+    bool vDown = glfwGetKey(window, GLFW_KEY_V) == GLFW_PRESS;
+    if (f3Down && vDown && (!lastF3 || !lastV)) {
+        Game::instance().toggleChunkRenderMode();
+    }
+
     lastF3 = f3Down;
     lastR = rDown;
+    lastV = vDown;
 }
 
 static void scrollCallback(GLFWwindow* window, double xoffset, double yoffset) {
@@ -426,6 +450,7 @@ static void scrollCallback(GLFWwindow* window, double xoffset, double yoffset) {
 
 void Player::syncViewDistance(int viewDistance) {
     VIEW_DISTANCE = viewDistance;
+    // Chunks are only loaded and drawn within the far fog distance, see viewRadiusBlocks
     FAR_FOG_DISTANCE = VIEW_DISTANCE * 16 - 1;
     NEAR_FOG_DISTANCE = FAR_FOG_DISTANCE - (VIEW_DISTANCE * 2);
     BOTTOM_FOG_DISTANCE = std::max(90, VIEW_DISTANCE * 16);
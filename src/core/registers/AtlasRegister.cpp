@@ -1,6 +1,20 @@
 #include "core/registers/AtlasRegister.h"
 
+#include <algorithm>
+#include <cstring>
+#include <chrono>
+#include <fstream>
+
 Atlas::Atlas(const char* path) {
+    auto start = std::chrono::steady_clock::now();
+
+    const std::filesystem::path cachePath = std::filesystem::path(path) / CACHE_FILE;
+    const uint64_t sourceHash = hashSourceFiles(path);
+    if (loadCache(cachePath, sourceHash)) {
+        std::cout << "Block textures loaded from cache in "
+                  << std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count() << " ms\n";
+        return;
+    }
     
     std::vector<TextureFile> textures = loadTextures(path);
     if (textures.size() == 0) {
@@ -8,69 +22,141 @@ Atlas::Atlas(const char* path) {
         return;
     }
 
-    numTextures = textures.size();
+    buildLayers(textures);
+    saveCache(cachePath, sourceHash);
+    std::cout << "Block textures decoded in "
+              << std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count() << " ms\n";
+}
 
-    this->size = findLargestAtlas(numTextures);
+void Atlas::buildLayers(std::vector<TextureFile>& textures) {
+    // Directory order differs between systems, sorting keeps the layers the same everywhere
+    std::sort(textures.begin(), textures.end(), [](const TextureFile& a, const TextureFile& b) { return a.name < b.name; });
+
+    numTextures = textures.size();
 
     largestTexture = findLargestTexture(textures);
 
-    width = this->size * largestTexture;
+    const size_t layerBytes = static_cast<size_t>(largestTexture) * largestTexture * 4;
+    // Smaller textures sit in the corner of their layer, the rest stays transparent black
+    layerData.assign(layerBytes * numTextures, 0);
 
-    unsigned char* atlasData = new unsigned char[width * width * 4];
+    for (int i = 0; i < numTextures; i++) {
+        const TextureFile& texture = textures[i];
+        const int copyWidth = std::min(texture.width, largestTexture);
+        const int copyHeight = std::min(texture.height, largestTexture);
 
-    // Initialize atlas with transparent black (0, 0, 0, 0)
-    memset(atlasData, 0, width * width * 4);
+        for (int y = 0; y < copyHeight; y++) {
+            std::memcpy(layerData.data() + i * layerBytes + static_cast<size_t>(y) * largestTexture * 4,
+                        texture.data + static_cast<size_t>(y) * texture.width * 4, copyWidth * 4);
+        }
+        textureMap[texture.name] = i;
 
-    for (int i = 0; i < numTextures; i++) {
-        int xOffset = (i % this->size) * largestTexture;
-        int yOffset = (i / this->size) * largestTexture;
+        stbi_image_free(texture.data);
+    }
+}
 
-        for (int y = 0; y < largestTexture; y++) {
-            for (int x = 0; x < largestTexture; x++) {
-                int atlasIndex = ((yOffset + y) * width + (xOffset + x)) * 4;
-                int textureIndex = (y * largestTexture + x) * 4;
+// FNV-1a over the name, size and modification time of every texture, in name order
+uint64_t Atlas::hashSourceFiles(const std::filesystem::path& directory) {
+    std::vector<std::string> entries;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        if (!entry.is_regular_file() || entry.path().extension() != ".png" || entry.path().filename() == "block_atlas.png") continue;
 
-                atlasData[atlasIndex] = textures[i].data[textureIndex];         // Red
-                atlasData[atlasIndex + 1] = textures[i].data[textureIndex + 1]; // Green
-                atlasData[atlasIndex + 2] = textures[i].data[textureIndex + 2]; // Blue
-                atlasData[atlasIndex + 3] = textures[i].data[textureIndex + 3]; // Alpha
+        const auto modified = entry.last_write_time(error).time_since_epoch().count();
+        entries.push_back(entry.path().filename().string() + ":" + std::to_string(entry.file_size(error)) + ":" + std::to_string(modified));
+    }
+    std::sort(entries.begin(), entries.end());
 
-                textureMap[textures[i].name] = std::make_pair(xOffset, yOffset);
-            }
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const std::string& text) {
+        for (unsigned char c : text) {
+            hash ^= c;
+            hash *= 1099511628211ull;
         }
+    };
+    // Part of the key so a change to the layer layout invalidates old caches
+    mix("layers:" + std::to_string(CACHE_VERSION));
+    for (const std::string& entry : entries) mix(entry + "\n");
+    return hash;
+}
 
-        stbi_image_free(textures[i].data);
+// Layout: magic, version, source hash, tile size, layer count, name count, every name with its layer, the pixels
+bool Atlas::loadCache(const std::filesystem::path& cachePath, uint64_t sourceHash) {
+    std::ifstream in(cachePath, std::ios::binary);
+    if (!in) return false;
+
+    auto read = [&in](auto& value) { return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value))); };
+
+    uint32_t magic = 0, version = 0;
+    uint64_t hash = 0;
+    int32_t tileSize = 0, layers = 0, nameCount = 0;
+    if (!read(magic) || !read(version) || !read(hash) || !read(tileSize) || !read(layers) || !read(nameCount)) return false;
+    if (magic != CACHE_MAGIC || version != CACHE_VERSION || hash != sourceHash) return false;
+    if (tileSize <= 0 || tileSize > 4096 || layers <= 0 || layers > 2048) return false;
+
+    std::unordered_map<std::string, int> names;
+    for (int32_t i = 0; i < nameCount; ++i) {
+        uint16_t length = 0;
+        int32_t layer = 0;
+        if (!read(length)) return false;
+        std::string name(length, '\0');
+        if (!in.read(name.data(), length) || !read(layer) || layer < 0 || layer >= layers) return false;
+        names[name] = layer;
     }
 
-    stbi_write_png((std::string(path) + "block_atlas.png").c_str(), width, width, 4, atlasData, width * 4);
-    delete[] atlasData;
+    std::vector<unsigned char> pixels(static_cast<size_t>(tileSize) * tileSize * 4 * layers);
+    if (!in.read(reinterpret_cast<char*>(pixels.data()), pixels.size())) return false;
+
+    largestTexture = tileSize;
+    numTextures = layers;
+    textureMap = std::move(names);
+    layerData = std::move(pixels);
+    return true;
 }
 
-Atlas::~Atlas() {}
+void Atlas::saveCache(const std::filesystem::path& cachePath, uint64_t sourceHash) const {
+    // Written under a temporary name first, so an interrupted write never leaves a cache that looks valid
+    std::filesystem::path tempPath = cachePath;
+    tempPath += ".tmp";
 
-// Returns the size of the atlas
-int Atlas::getSize() {
-    return this->size;
-}
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            std::cerr << "Could not write block texture cache: " << cachePath.string() << std::endl;
+            return;
+        }
+
+        auto write = [&out](const auto& value) { out.write(reinterpret_cast<const char*>(&value), sizeof(value)); };
+        write(CACHE_MAGIC);
+        write(CACHE_VERSION);
+        write(sourceHash);
+        write(static_cast<int32_t>(largestTexture));
+        write(static_cast<int32_t>(numTextures));
+        write(static_cast<int32_t>(textureMap.size()));
+        for (const auto& [name, layer] : textureMap) {
+            write(static_cast<uint16_t>(name.size()));
+            out.write(name.data(), name.size());
+            write(static_cast<int32_t>(layer));
+        }
+        out.write(reinterpret_cast<const char*>(layerData.data()), layerData.size());
+        if (!out) return;
+    }
 
-// Returns the atlas texture
-Texture* Atlas::getAtlas() {
-    return this->atlas;
+    std::error_code error;
+    std::filesystem::rename(tempPath, cachePath, error);
+    if (error) std::cerr << "Could not write block texture cache: " << cachePath.string() << std::endl;
 }
 
-// Finds the largest square atlas size for a given number of files, in powers of 2 since those are most efficient in OpenGL
-int Atlas::findLargestAtlas(int numFiles) {
-    int largest = 1;
-    while (largest * largest < numFiles) {
-        largest *= 2;
-    }
-    return largest;
+Atlas::~Atlas() {}
+
+std::unique_ptr<Texture> Atlas::createTexture(GLuint slot) const {
+    return std::make_unique<Texture>(layerData.data(), largestTexture, largestTexture, numTextures, slot);
 }
 
 // Finds the texture with the largest size in a vector of textures
-int Atlas::findLargestTexture(std::vector<TextureFile> textures) {
+int Atlas::findLargestTexture(const std::vector<TextureFile>& textures) {
     int largest = 1;
-    for (TextureFile texture : textures) {
+    for (const TextureFile& texture : textures) {
         if (texture.width > largest) {
             largest = texture.width;
         }
@@ -78,8 +164,10 @@ int Atlas::findLargestTexture(std::vector<TextureFile> textures) {
     return largest;
 }
 
+// Textures are decoded as RGBA with the bottom row first, the way GL expects them
 std::vector<TextureFile> Atlas::loadTextures(const char* path) {
     std::vector<TextureFile> textures;
+    stbi_set_flip_vertically_on_load(true);
 
     #if defined(_WIN32)
     if (!std::filesystem::exists(path)) {
@@ -90,7 +178,7 @@ std::vector<TextureFile> Atlas::loadTextures(const char* path) {
         if (entry.is_regular_file() && entry.path().extension() == ".png") {
             if (entry.path().filename() != "block_atlas.png") {
                 TextureFile texture;
-                texture.data = stbi_load(entry.path().string().c_str(), &texture.width, &texture.height, &texture.nrChannels, 0);
+                texture.data = stbi_load(entry.path().string().c_str(), &texture.width, &texture.height, &texture.nrChannels, 4);
                 texture.name = entry.path().filename().string().substr(0, entry.path().filename().string().find_last_of("."));
                 if (texture.data == NULL) {
                     std::cerr << "Error loading texture: " << entry.path().string() << std::endl;
@@ -111,7 +199,7 @@ std::vector<TextureFile> Atlas::loadTextures(const char* path) {
                     if (filename != "block_atlas.png") {
                         TextureFile texture;
                         std::string fullPath = std::string(path) + "/" + filename;
-                        texture.data = stbi_load(fullPath.c_str(), &texture.width, &texture.height, &texture.nrChannels, 0);
+                        texture.data = stbi_load(fullPath.c_str(), &texture.width, &texture.height, &texture.nrChannels, 4);
                         texture.name = filename.substr(0, filename.find_last_of("."));
                         if (texture.data == NULL) {
                             std::cerr << "Error loading texture: " << fullPath << std::endl;
@@ -150,8 +238,8 @@ void Atlas::linkBlocksToAtlas(BlockRegister* blockRegister) {
                 continue;
             }
 
-            float s = (float)textureMap[texture].first / (float)width;
-            float t = ((float)width - (float)textureMap[texture].second - (float)largestTexture) / (float)width;
+            float s = (float)textureMap[texture] * TEXTURE_LAYER_STRIDE;
+            float t = 0.0f;
 
             if (block.model == "block_full" || block.model == "block_slim") {
                 block_full_linking(block, texture, textureKey, s, t);
@@ -170,6 +258,8 @@ void Atlas::linkBlocksToAtlas(BlockRegister* blockRegister) {
             }
         }
     }
+
+    blockRegister->buildMeshTable();
 }
 
 // Linking function for blocks that are the default cube model
@@ -183,13 +273,13 @@ void Atlas::block_full_linking(Block& block, std::string texture, std::string te
                 texCoords = glm::vec2(s, t);
             }
             if (i % 4 == 3) {
-                texCoords = glm::vec2(s + (float)largestTexture / (float)width, t);
+                texCoords = glm::vec2(s + tileSpan, t);
             }
             if (i % 4 == 2) {
-                texCoords = glm::vec2(s + (float)largestTexture / (float)width, t + (float)largestTexture / (float)width);
+                texCoords = glm::vec2(s + tileSpan, t + tileSpan);
             }
             if (i % 4 == 1) {
-                texCoords = glm::vec2(s, t + (float)largestTexture / (float)width);
+                texCoords = glm::vec2(s, t + tileSpan);
             }
             if (block.vertices.size() < i) {
                 std::cerr << "Model block_full index [" << i << "] outside of range in texture: " << texture << " for face: " << textureKey << std::endl;
@@ -205,13 +295,13 @@ void Atlas::block_full_linking(Block& block, std::string texture, std::string te
                 texCoords = glm::vec2(s, t);
             }
             if (i == 0) {
-                texCoords = glm::vec2(s + (float)largestTexture / (float)width, t);
+                texCoords = glm::vec2(s + tileSpan, t);
             }
             if (i == 3) {
-                texCoords = glm::vec2(s + (float)largestTexture / (float)width, t + (float)largestTexture / (float)width);
+                texCoords = glm::vec2(s + tileSpan, t + tileSpan);
             }
             if (i == 2) {
-                texCoords = glm::vec2(s, t + (float)largestTexture / (float)width);
+                texCoords = glm::vec2(s, t + tileSpan);
             }
             if (block.vertices.size() < 19+i) {
                 std::cerr << "Model block_full index [" << i << "] outside of range in texture: " << texture << " for face: " << textureKey << std::endl;
@@ -225,13 +315,13 @@ void Atlas::block_full_linking(Block& block, std::string texture, std::string te
                 texCoords = glm::vec2(s, t);
             }
             if (i == 2) {
-                texCoords = glm::vec2(s + (float)largestTexture / (float)width, t);
+                texCoords = glm::vec2(s + tileSpan, t);
             }
             if (i == 1) {
-                texCoords = glm::vec2(s + (float)largestTexture / (float)width, t + (float)largestTexture / (float)width);
+                texCoords = glm::vec2(s + tileSpan, t + tileSpan);
             }
             if (i == 0) {
-                texCoords = glm::vec2(s, t + (float)largestTexture / (float)width);
+                texCoords = glm::vec2(s, t + tileSpan);
             }
             if (block.vertices.size() < 3+i) {
                 std::cerr << "Model block_full index [" << i << "] outside of range in texture: " << texture << " for face: " << textureKey << std::endl;
@@ -245,13 +335,13 @@ void Atlas::block_full_linking(Block& block, std::string texture, std::string te
                 texCoords = glm::vec2(s, t);
             }
             if (i == 3) {
-                texCoords = glm::vec2(s + (float)largestTexture / (float)width, t);
+                texCoords = glm::vec2(s + tileSpan, t);
             }
             if (i == 2) {
-                texCoords = glm::vec2(s + (float)largestTexture / (float)width, t + (float)largestTexture / (float)width);
+                texCoords = glm::vec2(s + tileSpan, t + tileSpan);
             }
             if (i == 1) {
-                texCoords = glm::vec2(s, t + (float)largestTexture / (float)width);
+                texCoords = glm::vec2(s, t + tileSpan);
             }
             if (block.vertices.size() < 7+i) {
                 std::cerr << "Model block_full index [" << i << "] outside of range in texture: " << texture << " for face: " << textureKey << std::endl;
@@ -265,13 +355,13 @@ void Atlas::block_full_linking(Block& block, std::string texture, std::string te
                 texCoords = glm::vec2(s, t);
             }
             if (i == 3) {
-                texCoords = glm::vec2(s + (float)largestTexture / (float)width, t);
+                texCoords = glm::vec2(s + tileSpan, t);
             }
             if (i == 2) {
-                texCoords = glm::vec2(s + (float)largestTexture / (float)width, t + (float)largestTexture / (float)width);
+                texCoords = glm::vec2(s + tileSpan, t + tileSpan);
             }
             if (i == 1) {
-                texCoords = glm::vec2(s, t + (float)largestTexture / (float)width);
+                texCoords = glm::vec2(s, t + tileSpan);
             }
             if (block.vertices.size() < i) {
                 std::cerr << "Model block_full index [" << i << "] outside of range in texture: " << texture << " for face: " << textureKey << std::endl;
@@ -285,13 +375,13 @@ void Atlas::block_full_linking(Block& block, std::string texture, std::string te
                 texCoords = glm::vec2(s, t);
             }
             if (i == 3) {
-                texCoords = glm::vec2(s + (float)largestTexture / (float)width, t);
+                texCoords = glm::vec2(s + tileSpan, t);
             }
             if (i == 2) {
-                texCoords = glm::vec2(s + (float)largestTexture / (float)width, t + (float)largestTexture / (float)width);
+                texCoords = glm::vec2(s + tileSpan, t + tileSpan);
             }
             if (i == 1) {
-                texCoords = glm::vec2(s, t + (float)largestTexture / (float)width);
+                texCoords = glm::vec2(s, t + tileSpan);
             }
             if (block.vertices.size() < 11+i) {
                 std::cerr << "Model block_full index [" << i << "] outside of range in texture: " << texture << " for face: " << textureKey << std::endl;
@@ -305,13 +395,13 @@ void Atlas::block_full_linking(Block& block, std::string texture, std::string te
                 texCoords = glm::vec2(s, t);
             }
             if (i == 3) {
-                texCoords = glm::vec2(s + (float)largestTexture / (float)width, t);
+                texCoords = glm::vec2(s + tileSpan, t);
             }
             if (i == 2) {
-                texCoords = glm::vec2(s + (float)largestTexture / (float)width, t + (float)largestTexture / (float)width);
+                texCoords = glm::vec2(s + tileSpan, t + tileSpan);
             }
             if (i == 1) {
-                texCoords = glm::vec2(s, t + (float)largestTexture / (float)width);
+                texCoords = glm::vec2(s, t + tileSpan);
             }
             if (block.vertices.size() < 15+i) {
                 std::cerr << "Model block_full index [" << i << "] outside of range in texture: " << texture << " for face: " << textureKey << std::endl;
@@ -332,13 +422,13 @@ void Atlas::covered_cross_linking(Block& block, std::string texture, std::string
                 texCoords = glm::vec2(s, t);
             }
             if (i % 4 == 0) {
-                texCoords = glm::vec2(s + (float)largestTexture / (float)width, t);
+                texCoords = glm::vec2(s + tileSpan, t);
             }
             if (i % 4 == 3) {
-                texCoords = glm::vec2(s + (float)largestTexture / (float)width, t + (float)largestTexture / (float)width);
+                texCoords = glm::vec2(s + tileSpan, t + tileSpan);
             }
             if (i % 4 == 2) {
-                texCoords = glm::vec2(s, t + (float)largestTexture / (float)width);
+                texCoords = glm::vec2(s, t + tileSpan);
             }
             if (block.vertices.size() < i) {
                 std::cerr << "Model covered_cross index [" << i << "] outside of range in texture: " << texture << " for face: " << textureKey << std::endl;
@@ -358,13 +448,13 @@ void Atlas::cross_linking(Block& block, std::string texture, std::string texture
                 texCoords = glm::vec2(s, t);
             }
             if (i % 4 == 0) {
-                texCoords = glm::vec2(s + (float)largestTexture / (float)width, t);
+                texCoords = glm::vec2(s + tileSpan, t);
             }
             if (i % 4 == 3) {
-                texCoords = glm::vec2(s + (float)largestTexture / (float)width, t + (float)largestTexture / (float)width);
+                texCoords = glm::vec2(s + tileSpan, t + tileSpan);
             }
             if (i % 4 == 2) {
-                texCoords = glm::vec2(s, t + (float)largestTexture / (float)width);
+                texCoords = glm::vec2(s, t + tileSpan);
             }
             if (block.vertices.size() < i) {
                 std::cerr << "Model cross index [" << i << "] outside of range in texture: " << texture << " for face: " << textureKey << std::endl;
@@ -31,7 +31,9 @@ BlockRegister& BlockRegister::instance() {
 }
 
 // Default constructor
-BlockRegister::BlockRegister() {
+BlockRegister::BlockRegister() : BlockRegister(Game::instance().getBasePath()) {}
+
+BlockRegister::BlockRegister(const std::string& basePath) : basePath(basePath) {
     parseBlockRegistryJson();
     loadBlocks();
     saveBlockRegistryJson();
@@ -70,6 +72,51 @@ int BlockRegister::getBlockIndex(std::string name) {
     return -1;
 }
 
+// Flattens block models and transparency into the table read by the chunk mesher
+void BlockRegister::buildMeshTable() {
+    meshTable.blocks.assign(blocks.size(), BlockMeshInfo());
+    meshTable.vertices.clear();
+    meshTable.fitsFaceRecords = blocks.size() <= FACE_RECORD_MAX_BLOCKS;
+    // Instances pack the block ID in 16 bits like face records
+    meshTable.instancedPlants = instancedPlants && meshTable.fitsFaceRecords;
+    meshTable.plantModelQuads = {};
+
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        const Block& block = blocks[i];
+        BlockMeshInfo& info = meshTable.blocks[i];
+
+        info.isTransparent = block.isTransparent;
+        info.model = block.isAir ? BlockModel::NONE : block.modelType;
+        info.bucket = (info.model == BlockModel::FULL && !block.isTransparent) ? MESH_BUCKET_OPAQUE : MESH_BUCKET_CUTOUT;
+
+        if (block.vertices.size() % 4 != 0) {
+            std::cerr << "Block model mesh is not quad-based: " << block.name << " (" << block.vertices.size() << " verts)" << std::endl;
+            info.model = BlockModel::NONE;
+            continue;
+        }
+        if (info.model == BlockModel::FULL && block.vertices.size() != 24) {
+            std::cerr << "Block model block_full does not have 6 faces: " << block.name << std::endl;
+            info.model = BlockModel::NONE;
+            continue;
+        }
+
+        info.firstVertex = static_cast<uint32_t>(meshTable.vertices.size());
+        info.quadCount = static_cast<uint32_t>(block.vertices.size() / 4);
+        if (info.quadCount > FACE_RECORD_MAX_QUADS) meshTable.fitsFaceRecords = false;
+        meshTable.vertices.insert(meshTable.vertices.end(), block.vertices.begin(), block.vertices.end());
+
+        if (!meshTable.instancedPlants || (info.model != BlockModel::CROSS && info.model != BlockModel::COVERED_CROSS)) continue;
+        const int plantModel = info.model == BlockModel::CROSS ? PLANT_MODEL_CROSS : PLANT_MODEL_COVERED_CROSS;
+        uint32_t& modelQuads = meshTable.plantModelQuads[plantModel];
+        if (modelQuads != 0 && modelQuads != info.quadCount) {
+            std::cerr << "Plant model of " << block.name << " has a different quad count than other blocks of its model, it is meshed instead" << std::endl;
+            continue;
+        }
+        modelQuads = info.quadCount;
+        info.plantModel = static_cast<int8_t>(plantModel);
+    }
+}
+
 // Registers a new block with the specified properties
 void BlockRegister::registerBlock(std::string name, std::vector<std::string> states, std::vector<std::string> textures,
                                   std::string model, bool solid, bool transparent, bool air, BLOCKTYPE type) {                 
@@ -153,11 +200,11 @@ void BlockRegister::parseBlockMapJson(std::string contents, std::string fileName
 // Loads blocks from JSON files in a specified directory
 void BlockRegister::loadBlocks() {
     #if defined(_WIN32)
-    if (!std::filesystem::exists(Game::instance().getBasePath() + "/assets/maps/blocks/")) {
+    if (!std::filesystem::exists(basePath + "/assets/maps/blocks/")) {
         std::cerr << "Error locating folder: ./assets/maps/blocks/" << std::endl;
         return;
     }
-    for (const auto& entry : std::filesystem::directory_iterator(Game::instance().getBasePath() + "/assets/maps/blocks/")) {
+    for (const auto& entry : std::filesystem::directory_iterator(basePath + "/assets/maps/blocks/")) {
         if (entry.is_regular_file() && entry.path().extension() == ".json") {
             std::ifstream blockFile(entry.path().string());
             if (!blockFile.is_open()) {
@@ -175,12 +222,12 @@ void BlockRegister::loadBlocks() {
     #else
     DIR* dir;
     struct dirent* ent;
-    if ((dir = opendir(Game::instance().getBasePath() + "/assets/maps/blocks/")) != NULL) {
+    if ((dir = opendir((basePath + "/assets/maps/blocks/").c_str())) != NULL) {
         while ((ent = readdir(dir)) != NULL) {
             if (ent->d_type == DT_REG) {
                 std::string filename = ent->d_name;
                 if (filename.substr(filename.find_last_of(".") + 1) == "json") {
-                    std::string fullPath = Game::instance().getBasePath() + "/assets/maps/blocks/" + filename;
+                    std::string fullPath = basePath + "/assets/maps/blocks/" + filename;
                     std::ifstream blockFile(fullPath);
                     if (!blockFile.is_open()) {
                         std::cerr << "Failed to open block file: " << fullPath << std::endl;
@@ -206,7 +253,7 @@ void BlockRegister::saveBlockRegistryJson() {
         blockRegistryJson[name] = id;
     }
 
-    std::ofstream file(Game::instance().getBasePath() + "/registry/block_registry.json");
+    std::ofstream file(basePath + "/registry/block_registry.json");
     if (!file) {
         std::cerr << "Error opening file for writing: ./registry/block_registry.json" << std::endl;
         return;
@@ -218,7 +265,7 @@ void BlockRegister::saveBlockRegistryJson() {
 
 // Parses the block registry JSON file to create a mapping of block names to IDs
 void BlockRegister::parseBlockRegistryJson() {
-    std::ifstream file(Game::instance().getBasePath() + "/registry/block_registry.json");
+    std::ifstream file(basePath + "/registry/block_registry.json");
     if (!file) {
         std::cerr << "Error opening file for reading: ./registry/block_registry.json" << std::endl;
         return;
@@ -241,13 +288,17 @@ void BlockRegister::parseBlockRegistryJson() {
 
 // Sets vertices and normals for a block based on its model
 void BlockRegister::linkModelToBlock(Block& block) {
+    block.modelType = BlockModel::NONE;
     if (block.model == "block_full" || block.model == "block_slim") {
+        block.modelType = BlockModel::FULL;
         link_block_full(block);
     }
     if (block.model == "covered_cross") {
+        block.modelType = BlockModel::COVERED_CROSS;
         link_covered_cross(block);
     }
     if (block.model == "cross") {
+        block.modelType = BlockModel::CROSS;
         link_cross(block);
     }
     // if (block.model == "block_ore") {
@@ -263,9 +314,9 @@ void BlockRegister::linkModelToBlock(Block& block) {
 void BlockRegister::link_block_full(Block& block) {
     std::string modelPath;
     if (block.model == "block_full") {
-        modelPath = Game::instance().getBasePath() + "/assets/models/block_full.obj";
+        modelPath = basePath + "/assets/models/block_full.obj";
     } else if (block.model == "block_slim") {
-        modelPath = Game::instance().getBasePath() + "/assets/models/block_slim.obj";
+        modelPath = basePath + "/assets/models/block_slim.obj";
     } else {
         std::cerr << "Invalid block model: " << block.model << std::endl;
         return;
@@ -346,7 +397,7 @@ void BlockRegister::link_block_full(Block& block) {
 // Model specific linking for the covered cross model
 void BlockRegister::link_covered_cross(Block& block) {
 
-    std::string modelPath = Game::instance().getBasePath() + "/assets/models/covered_cross.obj";
+    std::string modelPath = basePath + "/assets/models/covered_cross.obj";
     std::ifstream file(modelPath);
     if (!file.is_open()) {
         std::cerr << "Failed to open block model file: " << modelPath << std::endl;
@@ -392,7 +443,7 @@ void BlockRegister::link_covered_cross(Block& block) {
 }
 
 void BlockRegister::link_cross(Block& block) {
-    std::string modelPath = Game::instance().getBasePath() + "/assets/models/cross.obj";
+    std::string modelPath = basePath + "/assets/models/cross.obj";
     std::ifstream file(modelPath);
     if (!file.is_open()) {
         std::cerr << "Failed to open block model file: " << modelPath << std::endl;
@@ -436,7 +487,7 @@ void BlockRegister::link_cross(Block& block) {
 }
 
 void BlockRegister::link_ore_block(Block& block) {
-    std::string modelPath = Game::instance().getBasePath() + "/assets/models/block_ore.obj";
+    std::string modelPath = basePath + "/assets/models/block_ore.obj";
     std::ifstream file(modelPath);
     if (!file.is_open()) {
         std::cerr << "Failed to open block model file: " << modelPath << std::endl;
@@ -9,16 +9,20 @@ namespace BiomeNoise {
     thread_local FastNoiseLite tempNoise;
     thread_local FastNoiseLite humidNoise;
 
+    thread_local bool noiseInitialized = false;
+
     void ensureInitialized() {
-        static thread_local bool initialized = false;
-        if (!initialized) {
+        if (!noiseInitialized) {
             initializeNoiseGenerator();
-            initialized = true;
         }
     }
     
     void initializeNoiseGenerator() {
-        int seed = Game::instance().getWorld().getSeed();
+        initializeNoiseGenerator(Game::instance().getWorld().getSeed());
+    }
+
+    void initializeNoiseGenerator(int seed) {
+        noiseInitialized = true;
 
         noiseGenerator.SetSeed(seed);
         noiseGenerator.SetNoiseType(FastNoiseLite::NoiseType_Perlin);
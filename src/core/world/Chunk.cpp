@@ -1,4 +1,5 @@
 #include "core/world/Chunk.h"
+#include "core/world/ChunkMesher.h"
 
 #include <random>
 
@@ -13,6 +14,14 @@ void Chunk::generateTerrain() {
     int worldMaxY = worldMinY + CHUNK_SIZE;
 
     if (BiomeNoise::isChunkLikelyEmpty(position)) {
+        // Chunks below the surface are left empty but stand for solid ground, nothing can be seen through them
+        bool buried = true;
+        const int samples[5][2] = { { 0, 0 }, { CHUNK_SIZE - 1, 0 }, { 0, CHUNK_SIZE - 1 }, { CHUNK_SIZE - 1, CHUNK_SIZE - 1 }, { CHUNK_SIZE / 2, CHUNK_SIZE / 2 } };
+        for (const auto& sample : samples) {
+            float height = BiomeNoise::generateBlendedHeight(position.x * CHUNK_SIZE + sample[0], position.z * CHUNK_SIZE + sample[1]);
+            if (static_cast<int>(height) < worldMaxY) buried = false;
+        }
+        visibility.store(buried ? ChunkVisibility::NONE : ChunkVisibility::ALL, std::memory_order_relaxed);
         mesh.isEmpty = true;
         return;
     }
@@ -158,199 +167,277 @@ void Chunk::generateTerrain() {
         }
     }
     mesh.isEmpty = false;
+    updateVisibility();
 }
 
-// Retrieves a block from the blocks array using 3D coordinates
-const Block& Chunk::getBlock(int x, int y, int z) const {
-    int idx = index(x, y, z);
-    if (idx == -1) {
-        std::cerr << "Chunk::getBlock: index out of chunk bounds at " << x << ", " << y << ", " << z << std::endl;
-        return BlockRegister::instance().blocks[0]; // Return air block if out of bounds
+// Flood fills the non-opaque blocks and links the faces each connected region touches.
+// Cutting any face off from the others takes at least a full 16x16 layer of opaque blocks,
+// so chunks with fewer are open in every direction without filling
+void Chunk::updateVisibility() {
+    const BlockMeshTable& table = BlockRegister::instance().getMeshTable();
+    const BlockMeshInfo* info = table.blocks.data();
+    const size_t blockCount = table.blocks.size();
+
+    constexpr int BLOCKS = CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE;
+    std::array<bool, BLOCKS> closed;
+    int opaqueBlocks = 0;
+    for (int i = 0; i < BLOCKS; ++i) {
+        const uint16_t id = blocks[i];
+        closed[i] = id < blockCount && info[id].model == BlockModel::FULL && !info[id].isTransparent;
+        opaqueBlocks += closed[i];
     }
-    return BlockRegister::instance().blocks[blocks[idx]];
-}
 
-// Sets the block ID in the blocks array using 3D coordinates
-void Chunk::setBlockID(int x, int y, int z, int blockID) {
-    int idx = index(x, y, z);
-    if (idx == -1) {
-        std::cerr << "Chunk::setBlockID: index out of chunk bounds at " << x << ", " << y << ", " << z << std::endl;
+    if (opaqueBlocks < CHUNK_SIZE * CHUNK_SIZE) {
+        visibility.store(ChunkVisibility::ALL, std::memory_order_relaxed);
+        return;
+    }
+    if (opaqueBlocks == BLOCKS) {
+        visibility.store(ChunkVisibility::NONE, std::memory_order_relaxed);
         return;
     }
-    blocks[idx] = blockID;
-}
 
-// Retrieves the chunk position
-ChunkPosition Chunk::getPosition() const {
-    return position;
-}
+    ChunkVisibility result;
+    result.faceLinks = ChunkVisibility::NONE;
+
+    std::array<uint16_t, BLOCKS> queue;
+    const int last = CHUNK_SIZE - 1;
+    for (int start = 0; start < BLOCKS; ++start) {
+        if (closed[start]) continue;
+
+        // Filled blocks are closed as they are queued, so each block is visited once across all regions
+        uint8_t faces = 0;
+        int head = 0, tail = 0;
+        queue[tail++] = static_cast<uint16_t>(start);
+        closed[start] = true;
+
+        while (head < tail) {
+            const int i = queue[head++];
+            const int x = i % CHUNK_SIZE;
+            const int z = (i / CHUNK_SIZE) % CHUNK_SIZE;
+            const int y = i / (CHUNK_SIZE * CHUNK_SIZE);
+
+            if (z == 0) faces |= 1 << BACK;
+            if (y == 0) faces |= 1 << BOTTOM;
+            if (z == last) faces |= 1 << FRONT;
+            if (x == 0) faces |= 1 << LEFT;
+            if (x == last) faces |= 1 << RIGHT;
+            if (y == last) faces |= 1 << TOP;
+
+            for (int face = 0; face < 6; ++face) {
+                const int nx = x + FACE_OFFSETS[face].x;
+                const int ny = y + FACE_OFFSETS[face].y;
+                const int nz = z + FACE_OFFSETS[face].z;
+                if (nx < 0 || nx > last || ny < 0 || ny > last || nz < 0 || nz > last) continue;
+
+                const int neighbor = index(nx, ny, nz);
+                if (closed[neighbor]) continue;
+                closed[neighbor] = true;
+                queue[tail++] = static_cast<uint16_t>(neighbor);
+            }
+        }
+        result.connect(faces);
+    }
 
-// Sets the chunk position
-void Chunk::setPosition(const ChunkPosition& pos) {
-    position = pos;
+    visibility.store(result.faceLinks, std::memory_order_relaxed);
 }
 
-// Generates the mesh for the chunk, considering neighboring chunks
-void Chunk::generateMesh(std::vector<Vertex>& vertices, std::vector<GLuint>& indices,
-                         std::function<int(glm::ivec3 offset, int, int, int)> getBlockIDFromNeighbor) const
-{
-    thread_local std::vector<bool> isTransparentCache;
-    thread_local const std::vector<Block>* blockListPtr = &BlockRegister::instance().blocks;
-
-    // Ensure the transparency cache is up-to-date
-    if (isTransparentCache.size() != blockListPtr->size()) {
-        isTransparentCache.resize(blockListPtr->size());
-        for (size_t i = 0; i < blockListPtr->size(); ++i) {
-            isTransparentCache[i] = (*blockListPtr)[i].isTransparent;
+// Meshes the chunk from 2^lodLevel downsampled block data. A downsampled cell is solid when at least half of
+// its blocks are full blocks and takes the topmost full block as its material, so surfaces keep their look.
+// Border faces are always emitted, which closes every chunk and hides steps between different LOD levels
+void Chunk::generateLodMesh(std::vector<Vertex>& vertices, std::vector<GLuint>& indices, int lodLevel, MeshCellRanges* cellRanges) const {
+    const BlockMeshTable& table = BlockRegister::instance().getMeshTable();
+    const BlockMeshInfo* info = table.blocks.data();
+    const int blockCount = static_cast<int>(table.blocks.size());
+
+    const int step = 1 << lodLevel;
+    const int size = CHUNK_SIZE / step;
+    const int fillThreshold = (step * step * step + 1) / 2;
+
+    auto lodIndex = [size](int x, int y, int z) { return x + y * size * size + z * size; };
+
+    std::array<uint16_t, CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE> lodBlocks;
+    for (int ly = 0; ly < size; ++ly) {
+        for (int lz = 0; lz < size; ++lz) {
+            for (int lx = 0; lx < size; ++lx) {
+                int solid = 0;
+                int material = 0;
+
+                for (int y = ly * step + step - 1; y >= ly * step; --y) {
+                    for (int z = lz * step; z < lz * step + step; ++z) {
+                        for (int x = lx * step; x < lx * step + step; ++x) {
+                            const int blockID = blocks[x + (y * CHUNK_SIZE * CHUNK_SIZE) + (z * CHUNK_SIZE)];
+                            if (blockID <= 0 || blockID >= blockCount || info[blockID].model != BlockModel::FULL) continue;
+                            if (material == 0) material = blockID;
+                            ++solid;
+                        }
+                    }
+                }
+
+                lodBlocks[lodIndex(lx, ly, lz)] = solid >= fillThreshold ? material : 0;
+            }
         }
     }
 
-    GLuint indexOffset = 0;
-    glm::vec3 chunkOffset = glm::vec3(position.x, position.y, position.z) * (float)CHUNK_SIZE;
+    std::array<uint8_t, CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE> faceMasks = {};
+    std::array<uint32_t, MESH_BUCKET_COUNT> bucketQuads = {};
 
-    for (int x = 0; x < CHUNK_SIZE; ++x) {
-        for (int y = 0; y < CHUNK_SIZE; ++y) {
-            for (int z = 0; z < CHUNK_SIZE; ++z) {
-                int blockID = getBlockID(x, y, z);
-                if (blockID <= 0 || blockID >= (int)blockListPtr->size()) continue;
-
-                const Block& block = (*blockListPtr)[blockID];
-                if (block.isAir) continue;
-
-                bool transparent = block.isTransparent;
-
-                if (block.model == "covered_cross") {
-                    addCoveredCrossMesh(
-                        block, x, y, z,
-                        vertices, indices,
-                        indexOffset,
-                        chunkOffset
-                    );
-                    continue;
-                }
-
-                if (block.model == "cross") {
-                    addCrossMesh(
-                        block, x, y, z,
-                        vertices, indices,
-                        indexOffset,
-                        chunkOffset
-                    );
-                    continue;
-                }
+    for (int ly = 0; ly < size; ++ly) {
+        for (int lz = 0; lz < size; ++lz) {
+            for (int lx = 0; lx < size; ++lx) {
+                const int idx = lodIndex(lx, ly, lz);
+                const int blockID = lodBlocks[idx];
+                if (blockID == 0) continue;
 
+                uint8_t mask = 0;
                 for (int face = 0; face < 6; ++face) {
-                    glm::ivec3 offset = FACE_OFFSETS[face];
-                    int nx = x + offset.x;
-                    int ny = y + offset.y;
-                    int nz = z + offset.z;
-
-                    int neighborID = -1;
-                    if (nx < 0 || nx >= CHUNK_SIZE ||
-                        ny < 0 || ny >= CHUNK_SIZE ||
-                        nz < 0 || nz >= CHUNK_SIZE) {
-                        neighborID = getBlockIDFromNeighbor(offset, x, y, z);
-                    } else {
-                        neighborID = getBlockID(nx, ny, nz);
-                    }
+                    const int nx = lx + FACE_OFFSETS[face].x;
+                    const int ny = ly + FACE_OFFSETS[face].y;
+                    const int nz = lz + FACE_OFFSETS[face].z;
 
-                    if (neighborID < 0 || neighborID >= (int)isTransparentCache.size()) continue;
-                    if (!isTransparentCache[neighborID] || neighborID == blockID) continue;
+                    if (nx >= 0 && nx < size && ny >= 0 && ny < size && nz >= 0 && nz < size) {
+                        const int neighborID = lodBlocks[lodIndex(nx, ny, nz)];
+                        if (!info[neighborID].isTransparent || neighborID == blockID) continue;
+                    }
 
-                    addBlockFaceMesh(
-                        block, x, y, z, face,
-                        vertices, indices,
-                        indexOffset,
-                        chunkOffset
-                    );
+                    mask |= 1 << face;
+                    ++bucketQuads[info[blockID].bucket];
                 }
+                faceMasks[idx] = mask;
             }
         }
     }
-}
 
-void Chunk::addBlockFaceMesh(const Block& block, int x, int y, int z, int face,
-                              std::vector<Vertex>& vertices, std::vector<GLuint>& indices,
-                              GLuint& indexOffset, glm::vec3 chunkOffset) const {
-    std::vector<Vertex> faceVerts;
-    getFaceVertices(face, block, faceVerts);
+    const uint32_t opaqueQuads = bucketQuads[MESH_BUCKET_OPAQUE];
+    const uint32_t quadCount = opaqueQuads + bucketQuads[MESH_BUCKET_CUTOUT];
 
-    for (auto& vtx : faceVerts) {
-        Vertex v = vtx;
-        v.position += chunkOffset + glm::vec3(x, y, z);
-        vertices.push_back(v);
+    // No cell layout at this resolution, each bucket is reported as a single slot
+    if (cellRanges) {
+        std::fill(cellRanges->begin(), cellRanges->begin() + 1, 0);
+        std::fill(cellRanges->begin() + 1, cellRanges->begin() + MESH_CELL_COUNT + 1, opaqueQuads);
+        std::fill(cellRanges->begin() + MESH_CELL_COUNT + 1, cellRanges->end(), quadCount);
     }
+    if (quadCount == 0) return;
 
-    indices.insert(indices.end(), {
-        indexOffset, indexOffset + 2, indexOffset + 1,
-        indexOffset, indexOffset + 3, indexOffset + 2
-    });
-    indexOffset += 4;
-}
+    const size_t firstVertex = vertices.size();
+    const size_t firstIndex = indices.size();
+    vertices.resize(firstVertex + quadCount * 4);
+    indices.resize(firstIndex + quadCount * 6);
 
-void Chunk::addCoveredCrossMesh(const Block& block, int x, int y, int z,
-                              std::vector<Vertex>& vertices, std::vector<GLuint>& indices,
-                              GLuint& indexOffset, glm::vec3 chunkOffset) const {
-    int modelVertexCount = (int)block.vertices.size();
-    if (modelVertexCount % 4 != 0) {
-        std::cerr << "Block model mesh is not quad-based: " << modelVertexCount << " verts" << std::endl;
-        return;
-    }
+    Vertex* outVertices = vertices.data() + firstVertex;
+    GLuint* outIndices = indices.data() + firstIndex;
+    GLuint baseIndex = static_cast<GLuint>(firstVertex);
 
-    for (const auto& vtx : block.vertices) {
-        Vertex v = vtx;
-        v.position += chunkOffset + glm::vec3(x, y, z);
-        vertices.push_back(v);
-    }
+    const glm::vec3 chunkOffset = glm::vec3(position.x, position.y, position.z) * (float)CHUNK_SIZE;
+    const Vertex* modelVertices = table.vertices.data();
+
+    for (int bucket = 0; bucket < MESH_BUCKET_COUNT; ++bucket) {
+        if (bucketQuads[bucket] == 0) continue;
 
-    for (GLuint i = 0; i < modelVertexCount; i += 4) {
-        indices.insert(indices.end(), {
-            indexOffset + i, indexOffset + i + 2, indexOffset + i + 1,
-            indexOffset + i, indexOffset + i + 3, indexOffset + i + 2
-        });
+        for (int ly = 0; ly < size; ++ly) {
+            for (int lz = 0; lz < size; ++lz) {
+                for (int lx = 0; lx < size; ++lx) {
+                    const int idx = lodIndex(lx, ly, lz);
+                    const uint8_t mask = faceMasks[idx];
+                    if (mask == 0) continue;
+
+                    const BlockMeshInfo& block = info[lodBlocks[idx]];
+                    if (block.bucket != bucket) continue;
+
+                    const Vertex* src = modelVertices + block.firstVertex;
+
+                    // Models are unit cubes, scale them about their minimum corner to cover the whole cell
+                    glm::vec3 modelMin = src[0].position;
+                    for (int i = 1; i < 24; ++i) modelMin = glm::min(modelMin, src[i].position);
+                    const glm::vec3 cellOrigin = chunkOffset + glm::vec3(lx, ly, lz) * (float)step;
+
+                    for (int face = 0; face < 6; ++face) {
+                        if (!(mask & (1 << face))) continue;
+
+                        Vertex scaled[4];
+                        for (int i = 0; i < 4; ++i) {
+                            scaled[i] = src[face * 4 + i];
+                            scaled[i].position = modelMin + (scaled[i].position - modelMin) * (float)step;
+                            // The tile repeats across the cell instead of being stretched over it
+                            scaled[i].texCoords = scaleTexCoords(scaled[i].texCoords, (float)step);
+                        }
+
+                        ChunkMesher::writeQuad(scaled, cellOrigin, outVertices, outIndices, baseIndex);
+                        outVertices += 4;
+                        outIndices += 6;
+                        baseIndex += 4;
+                    }
+                }
+            }
+        }
     }
+}
 
-    indexOffset += modelVertexCount;
+// Retrieves a block from the blocks array using 3D coordinates
+const Block& Chunk::getBlock(int x, int y, int z) const {
+    int idx = index(x, y, z);
+    if (idx == -1) {
+        std::cerr << "Chunk::getBlock: index out of chunk bounds at " << x << ", " << y << ", " << z << std::endl;
+        return BlockRegister::instance().blocks[0]; // Return air block if out of bounds
+    }
+    return BlockRegister::instance().blocks[blocks[idx]];
 }
 
-void Chunk::addCrossMesh(const Block& block, int x, int y, int z,
-                         std::vector<Vertex>& vertices, std::vector<GLuint>& indices,
-                         GLuint& indexOffset, glm::vec3 chunkOffset) const {
-    int modelVertexCount = static_cast<int>(block.vertices.size());
-    if (modelVertexCount % 4 != 0) {
-        std::cerr << "Block model mesh is not quad-based: " << modelVertexCount << " verts" << std::endl;
+// Sets the block ID in the blocks array using 3D coordinates
+void Chunk::setBlockID(int x, int y, int z, int blockID) {
+    int idx = index(x, y, z);
+    if (idx == -1) {
+        std::cerr << "Chunk::setBlockID: index out of chunk bounds at " << x << ", " << y << ", " << z << std::endl;
         return;
     }
+    blocks[idx] = blockID;
+}
 
-    // Compute world coordinates
-    int worldX = x + position.x * CHUNK_SIZE;
-    int worldY = y + position.y * CHUNK_SIZE;
-    int worldZ = z + position.z * CHUNK_SIZE;
+// Retrieves the chunk position
+ChunkPosition Chunk::getPosition() const {
+    return position;
+}
 
-    // Consistent seed for this block position
-    size_t seed = std::hash<int>()(worldX) ^ (std::hash<int>()(worldY) << 1) ^ (std::hash<int>()(worldZ) << 2);
-    std::mt19937 rng(static_cast<unsigned int>(seed));
-    std::uniform_real_distribution<float> offsetDist(-0.25f, 0.25f);
+// Sets the chunk position
+void Chunk::setPosition(const ChunkPosition& pos) {
+    position = pos;
+}
 
-    float offsetX = offsetDist(rng);
-    float offsetZ = offsetDist(rng);
+// Counts the plants of each model first, so every model's instances are written straight into their own range
+void Chunk::generatePlantInstances(std::vector<uint32_t>& instances, PlantInstanceCounts& counts) const {
+    counts.fill(0);
+    const BlockMeshTable& table = BlockRegister::instance().getMeshTable();
+    if (!table.instancedPlants) return;
 
-    glm::vec3 posOffset = glm::vec3(x + offsetX, y, z + offsetZ);
+    const BlockMeshInfo* info = table.blocks.data();
+    const int blockCount = static_cast<int>(table.blocks.size());
 
-    for (const auto& vtx : block.vertices) {
-        Vertex v = vtx;
-        v.position += chunkOffset + posOffset;
-        vertices.push_back(v);
+    for (int idx = 0; idx < CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE; ++idx) {
+        const int blockID = blocks[idx];
+        if (blockID <= 0 || blockID >= blockCount || info[blockID].plantModel == NOT_A_PLANT) continue;
+        ++counts[info[blockID].plantModel];
     }
 
-    for (GLuint i = 0; i < modelVertexCount; i += 4) {
-        indices.insert(indices.end(), {
-            indexOffset + i, indexOffset + i + 2, indexOffset + i + 1,
-            indexOffset + i, indexOffset + i + 3, indexOffset + i + 2
-        });
+    uint32_t total = 0;
+    std::array<uint32_t, PLANT_MODEL_COUNT> next;
+    for (int model = 0; model < PLANT_MODEL_COUNT; ++model) {
+        next[model] = total;
+        total += counts[model];
     }
+    if (total == 0) return;
+
+    const size_t first = instances.size();
+    instances.resize(first + total);
+    uint32_t* out = instances.data() + first;
 
-    indexOffset += modelVertexCount;
+    for (int y = 0; y < CHUNK_SIZE; ++y) {
+        for (int z = 0; z < CHUNK_SIZE; ++z) {
+            for (int x = 0; x < CHUNK_SIZE; ++x) {
+                const int blockID = blocks[x + (y * CHUNK_SIZE * CHUNK_SIZE) + (z * CHUNK_SIZE)];
+                if (blockID <= 0 || blockID >= blockCount || info[blockID].plantModel == NOT_A_PLANT) continue;
+                out[next[info[blockID].plantModel]++] = ChunkMesher::packPlantInstance(x, y, z, blockID);
+            }
+        }
+    }
 }
 
 SavableChunk Chunk::makeSavableCopy() const {
@@ -358,17 +445,32 @@ SavableChunk Chunk::makeSavableCopy() const {
 
     copy.position = position;
     copy.blocks = blocks;
+
+    std::lock_guard<std::mutex> lock(mesh.stagingMutex);
     if (!mesh.stagingVertices.empty()) {
-        copy.vertices = std::move(mesh.stagingVertices);
+        copy.vertices = mesh.stagingVertices;
     } else {
         copy.vertices = mesh.vertices;
     }
     if (!mesh.stagingIndices.empty()) {
-        copy.indices = std::move(mesh.stagingIndices);
+        copy.indices = mesh.stagingIndices;
     } else {
         copy.indices = mesh.indices;
     }
 
+    if (!mesh.stagingVertices.empty()) {
+        copy.cellRanges = mesh.stagingCellRanges;
+        copy.hasCellRanges = true;
+        copy.lodLevel = mesh.stagingLodLevel;
+        copy.meshedNeighbors = mesh.stagingMeshedNeighbors;
+    } else {
+        copy.cellRanges = mesh.cellRanges;
+        copy.hasCellRanges = mesh.hasCellRanges;
+        copy.lodLevel = mesh.lodLevel;
+        copy.meshedNeighbors = mesh.meshedNeighbors;
+    }
+
+    copy.plantsInstanced = mesh.plantsInstanced;
     copy.hasMeshUpdate = mesh.hasNewMesh;
 
     return copy;
@@ -0,0 +1,183 @@
+#include "core/world/ChunkCuller.h"
+
+#include <cstdio>
+#include <algorithm>
+#include <cmath>
+
+void ChunkCuller::cull(const ChunkRenderList& renderList, const ChunkMap& chunks, const glm::mat4& cameraMatrix,
+                       const glm::vec3& cameraPosition, std::vector<const ChunkDrawRecord*>& visible) {
+    frustum.update(cameraMatrix);
+    visible.clear();
+    stats = Stats();
+
+    // Group the chunks by column and grow each column's vertical span
+    columnLookup.clear();
+    columns.clear();
+    entries.clear();
+    for (const ChunkDrawRecord& record : renderList.getRecords()) {
+        const ChunkPosition& pos = record.position;
+        const int64_t key = (static_cast<int64_t>(pos.x) << 32) ^ static_cast<uint32_t>(pos.z);
+        auto [it, inserted] = columnLookup.try_emplace(key, static_cast<uint32_t>(columns.size()));
+        if (inserted) {
+            columns.push_back({ pos.x, pos.z, pos.y, pos.y });
+        } else {
+            Column& column = columns[it->second];
+            column.minY = std::min(column.minY, pos.y);
+            column.maxY = std::max(column.maxY, pos.y);
+        }
+        ++columns[it->second].count;
+        entries.emplace_back(&record, it->second);
+    }
+
+    // Counting sort so every column's chunks are contiguous
+    uint32_t offset = 0;
+    for (Column& column : columns) {
+        column.first = offset;
+        offset += column.count;
+        column.count = 0;
+    }
+    columnChunks.resize(entries.size());
+    for (const auto& [record, columnIndex] : entries) {
+        Column& column = columns[columnIndex];
+        columnChunks[column.first + column.count++] = record;
+    }
+
+    columnBoxes.clear();
+    for (const Column& column : columns) {
+        columnBoxes.push(glm::vec3(column.x, column.minY, column.z) * (float)CHUNK_SIZE,
+                         glm::vec3(column.x + 1, column.maxY + 1, column.z + 1) * (float)CHUNK_SIZE);
+    }
+    frustum.classify(columnBoxes, columnResults);
+
+    // Columns crossing a frustum plane have their chunks tested one by one
+    chunkBoxes.clear();
+    partialChunks.clear();
+    for (size_t i = 0; i < columns.size(); ++i) {
+        const Column& column = columns[i];
+        if (columnResults[i] == Frustum::OUTSIDE || (viewRadius > 0.0f && !columnInViewRadius(column, cameraPosition))) {
+            if (columnResults[i] != Frustum::OUTSIDE) ++stats.columnsFogged;
+            ++stats.columnsCulled;
+            stats.culled += column.count;
+            continue;
+        }
+
+        for (uint32_t c = column.first; c < column.first + column.count; ++c) {
+            const ChunkDrawRecord* record = columnChunks[c];
+            if (columnResults[i] == Frustum::INSIDE) {
+                visible.push_back(record);
+                continue;
+            }
+            chunkBoxes.push(record->min, record->max);
+            partialChunks.push_back(record);
+        }
+    }
+
+    frustum.classify(chunkBoxes, chunkResults);
+    for (size_t i = 0; i < partialChunks.size(); ++i) {
+        if (chunkResults[i] == Frustum::OUTSIDE) {
+            ++stats.culled;
+            continue;
+        }
+        visible.push_back(partialChunks[i]);
+    }
+
+    stats.columns = static_cast<int>(columns.size());
+
+    if (occlusionCulling && !columns.empty()) {
+        int minY = columns[0].minY, maxY = columns[0].maxY;
+        for (const Column& column : columns) {
+            minY = std::min(minY, column.minY);
+            maxY = std::max(maxY, column.maxY);
+        }
+        markReachable(chunks, cameraPosition, minY, maxY);
+
+        frustumVisible.swap(visible);
+        visible.clear();
+        for (const ChunkDrawRecord* record : frustumVisible) {
+            if (reachable.count(record->position)) {
+                visible.push_back(record);
+            } else {
+                ++stats.occluded;
+            }
+        }
+    }
+
+    stats.drawn = static_cast<int>(visible.size());
+    sortFrontToBack(cameraPosition, visible);
+}
+
+// Horizontal distance from the camera to the nearest point of the column, fog only depends on xz distance
+bool ChunkCuller::columnInViewRadius(const Column& column, const glm::vec3& cameraPosition) const {
+    const float minX = column.x * static_cast<float>(CHUNK_SIZE);
+    const float minZ = column.z * static_cast<float>(CHUNK_SIZE);
+    const float dx = std::max({ minX - cameraPosition.x, 0.0f, cameraPosition.x - (minX + CHUNK_SIZE) });
+    const float dz = std::max({ minZ - cameraPosition.z, 0.0f, cameraPosition.z - (minZ + CHUNK_SIZE) });
+    return dx * dx + dz * dz < viewRadius * viewRadius;
+}
+
+// Nearer chunks are drawn first so their depth rejects the fragments of the ones behind them before shading.
+// Distances are to the chunk centers, which is close enough for boxes that never overlap
+void ChunkCuller::sortFrontToBack(const glm::vec3& cameraPosition, std::vector<const ChunkDrawRecord*>& visible) {
+    sortKeys.clear();
+    for (const ChunkDrawRecord* record : visible) {
+        const glm::vec3 offset = (record->min + record->max) * 0.5f - cameraPosition;
+        sortKeys.emplace_back(offset.x * offset.x + offset.y * offset.y + offset.z * offset.z, record);
+    }
+    std::sort(sortKeys.begin(), sortKeys.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    for (size_t i = 0; i < sortKeys.size(); ++i) visible[i] = sortKeys[i].second;
+}
+
+// Breadth first search from the camera's chunk. A chunk entered through one face is left through the faces
+// that face can see, into neighbors inside the frustum. Positions without a chunk are open air
+void ChunkCuller::markReachable(const ChunkMap& chunks, const glm::vec3& cameraPosition, int minY, int maxY) {
+    reachable.clear();
+    searchQueue.clear();
+
+    ChunkPosition start = {
+        static_cast<int>(std::floor(cameraPosition.x / CHUNK_SIZE)),
+        static_cast<int>(std::floor(cameraPosition.y / CHUNK_SIZE)),
+        static_cast<int>(std::floor(cameraPosition.z / CHUNK_SIZE))
+    };
+    // Above or below the loaded chunks the search starts from the nearest layer of them
+    start.y = std::clamp(start.y, minY, maxY);
+
+    // Loaded chunks never reach further out than the columns, so the search stays inside their span
+    int radius = 0;
+    for (const Column& column : columns) {
+        radius = std::max(radius, std::max(std::abs(column.x - start.x), std::abs(column.z - start.z)));
+    }
+
+    searchQueue.push_back({ start, 6, 0 });
+    reachable[start] = 1;
+
+    for (size_t head = 0; head < searchQueue.size(); ++head) {
+        const SearchStep step = searchQueue[head];
+
+        auto it = chunks.find(step.pos);
+        const ChunkVisibility visibility = it != chunks.end() && it->second ? it->second->getVisibility() : ChunkVisibility();
+
+        for (int face = 0; face < 6; ++face) {
+            if (step.directions & (1 << oppositeFace(face))) continue;
+            if (step.enteredFace != 6 && !visibility.canSee(step.enteredFace, face)) continue;
+
+            const ChunkPosition next = { step.pos.x + FACE_OFFSETS[face].x, step.pos.y + FACE_OFFSETS[face].y, step.pos.z + FACE_OFFSETS[face].z };
+            if (next.y < minY || next.y > maxY) continue;
+            if (std::abs(next.x - start.x) > radius || std::abs(next.z - start.z) > radius) continue;
+            if (reachable.count(next)) continue;
+
+            glm::vec3 min = glm::vec3(next.x, next.y, next.z) * (float)CHUNK_SIZE;
+            if (frustum.classify(min, min + glm::vec3((float)CHUNK_SIZE)) == Frustum::OUTSIDE) continue;
+
+            reachable[next] = 1;
+            searchQueue.push_back({ next, static_cast<uint8_t>(oppositeFace(face)), static_cast<uint8_t>(step.directions | (1 << face)) });
+        }
+    }
+}
+
+std::string ChunkCuller::summary() const {
+    char buffer[128];
+    std::snprintf(buffer, sizeof(buffer), "%d drawn, %d culled (%d/%d columns, %d past fog), %d occluded",
+                  stats.drawn, stats.culled, stats.columnsCulled, stats.columns, stats.columnsFogged, stats.occluded);
+    return buffer;
+}
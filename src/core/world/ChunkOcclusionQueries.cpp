@@ -0,0 +1,157 @@
+#include "core/world/ChunkOcclusionQueries.h"
+
+#include <cmath>
+#include <glm/gtc/matrix_transform.hpp>
+
+ChunkOcclusionQueries::ChunkOcclusionQueries() {}
+
+ChunkOcclusionQueries::~ChunkOcclusionQueries() {}
+
+void ChunkOcclusionQueries::init() {
+    std::vector<Vertex> cubeVerts = {
+        {{0,0,0}, {}, {}}, {{1,0,0}, {}, {}}, {{1,1,0}, {}, {}}, {{0,1,0}, {}, {}},
+        {{0,0,1}, {}, {}}, {{1,0,1}, {}, {}}, {{1,1,1}, {}, {}}, {{0,1,1}, {}, {}}
+    };
+
+    std::vector<GLuint> cubeIndices = {
+        0,2,1, 0,3,2,
+        4,5,6, 4,6,7,
+        0,1,5, 0,5,4,
+        3,6,2, 3,7,6,
+        0,4,7, 0,7,3,
+        1,2,6, 1,6,5
+    };
+
+    boxVAO = std::make_unique<VertexArrayObject>();
+    boxVAO->init();
+    boxVAO->bind();
+    boxVAO->addVertexBuffer(cubeVerts);
+    boxVAO->addElementBuffer(cubeIndices);
+    boxVAO->addAttribute(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+    boxVAO->unbind();
+}
+
+void ChunkOcclusionQueries::deleteBuffers() {
+    for (auto& [pos, state] : states) deleteQueries(state);
+    states.clear();
+    if (boxVAO) boxVAO->deleteBuffers();
+}
+
+void ChunkOcclusionQueries::deleteQueries(QueryState& state) {
+    for (GLuint& query : state.queries) {
+        if (query != 0) glDeleteQueries(1, &query);
+        query = 0;
+    }
+    state.pendingQueries = 0;
+}
+
+// Results arrive in the order the queries were issued, so once the last one is available all of them are
+void ChunkOcclusionQueries::readResults(QueryState& state) {
+    if (state.pendingQueries == 0) return;
+
+    GLuint available = 0;
+    glGetQueryObjectuiv(state.queries[state.pendingQueries - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) return;
+
+    bool anySamples = false;
+    for (int i = 0; i < state.pendingQueries; ++i) {
+        GLuint samples = 0;
+        glGetQueryObjectuiv(state.queries[i], GL_QUERY_RESULT, &samples);
+        anySamples |= samples != 0;
+    }
+    state.visible = anySamples;
+    state.pendingQueries = 0;
+}
+
+void ChunkOcclusionQueries::beginFrame(const std::vector<const ChunkDrawRecord*>& candidates, const glm::vec3& cameraPosition,
+                                       std::vector<const ChunkDrawRecord*>& draw, std::vector<const ChunkDrawRecord*>& drawQueried) {
+    ++frame;
+    draw.clear();
+    drawQueried.clear();
+    hiddenChunks.clear();
+    hiddenCount = 0;
+
+    const glm::ivec3 cameraChunk = glm::ivec3(glm::floor(cameraPosition / (float)CHUNK_SIZE));
+
+    for (const ChunkDrawRecord* record : candidates) {
+        const ChunkPosition& pos = record->position;
+        QueryState& state = states[pos];
+        state.lastSeenFrame = frame;
+        readResults(state);
+
+        // The camera can sit inside the boxes of the chunks around it, those are always drawn
+        if (std::abs(pos.x - cameraChunk.x) <= 1 && std::abs(pos.y - cameraChunk.y) <= 1 && std::abs(pos.z - cameraChunk.z) <= 1) {
+            state.visible = true;
+            draw.push_back(record);
+            continue;
+        }
+
+        if (!state.visible) {
+            ++hiddenCount;
+            if (state.pendingQueries == 0) hiddenChunks.push_back(pos);
+            continue;
+        }
+
+        const uint32_t stagger = static_cast<uint32_t>(std::hash<ChunkPosition>()(pos));
+        if (state.pendingQueries == 0 && (frame + stagger) % RETEST_INTERVAL == 0) {
+            drawQueried.push_back(record);
+        } else {
+            draw.push_back(record);
+        }
+    }
+
+    // Chunks that left the view or were unloaded give their queries back after a while
+    if (frame % FORGET_AFTER_FRAMES == 0) {
+        for (auto it = states.begin(); it != states.end();) {
+            if (frame - it->second.lastSeenFrame > FORGET_AFTER_FRAMES) {
+                deleteQueries(it->second);
+                it = states.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+void ChunkOcclusionQueries::beginChunkQuery(const ChunkPosition& pos, int pass) {
+    QueryState& state = states[pos];
+    if (state.queries[pass] == 0) glGenQueries(1, &state.queries[pass]);
+    glBeginQuery(GL_ANY_SAMPLES_PASSED, state.queries[pass]);
+    state.pendingQueries = static_cast<uint8_t>(pass + 1);
+}
+
+void ChunkOcclusionQueries::endChunkQuery() {
+    glEndQuery(GL_ANY_SAMPLES_PASSED);
+}
+
+void ChunkOcclusionQueries::queryHiddenChunks(Shader& boxShader) {
+    if (hiddenChunks.empty() || !boxVAO) return;
+
+    // Boxes only test depth. They are grown slightly so faces lying on a chunk border do not hide the chunk
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glDepthMask(GL_FALSE);
+    glDisable(GL_CULL_FACE);
+
+    boxShader.use();
+    const GLint modelLocation = boxShader.getUniformLocation("model");
+    boxVAO->bind();
+    constexpr float margin = 0.1f;
+    for (const ChunkPosition& pos : hiddenChunks) {
+        QueryState& state = states[pos];
+        if (state.queries[0] == 0) glGenQueries(1, &state.queries[0]);
+
+        glm::vec3 min = glm::vec3(pos.x, pos.y, pos.z) * (float)CHUNK_SIZE - glm::vec3(margin);
+        glm::mat4 model = glm::scale(glm::translate(glm::mat4(1.0f), min), glm::vec3(CHUNK_SIZE + 2.0f * margin));
+        boxShader.setMat4(modelLocation, model);
+
+        glBeginQuery(GL_ANY_SAMPLES_PASSED, state.queries[0]);
+        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+        glEndQuery(GL_ANY_SAMPLES_PASSED);
+        state.pendingQueries = 1;
+    }
+    boxVAO->unbind();
+
+    glEnable(GL_CULL_FACE);
+    glDepthMask(GL_TRUE);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+}
@@ -0,0 +1,60 @@
+#include "core/world/ChunkRenderList.h"
+
+#include <algorithm>
+
+void ChunkRenderList::update(const std::shared_ptr<Chunk>& chunk) {
+    const ChunkMesh& mesh = chunk->mesh;
+    const ChunkPosition pos = chunk->getPosition();
+
+    ChunkDrawRecord record;
+    record.chunk = chunk;
+    record.position = pos;
+    record.min = glm::vec3(pos.x, pos.y, pos.z) * (float)CHUNK_SIZE;
+    record.max = record.min + glm::vec3((float)CHUNK_SIZE);
+    record.arenaHandle = mesh.arenaHandle;
+    record.pulling = mesh.faceRecordBuffer.isInitialized();
+
+    size_t total = 0;
+    size_t opaque = 0;
+    if (record.pulling) {
+        total = mesh.faceRecords.size();
+        opaque = std::min(mesh.getOpaqueQuadCount(), total);
+    } else if (!mesh.vertices.empty()) {
+        total = mesh.indices.size();
+        opaque = std::min(mesh.getOpaqueIndexCount(), total);
+    }
+    record.opaqueCount = static_cast<uint32_t>(opaque);
+    record.cutoutCount = static_cast<uint32_t>(total - opaque);
+    record.hasPlants = mesh.plantInstanceBuffer.isInitialized();
+    if (record.hasPlants) record.plantCounts = mesh.plantCounts;
+
+    if (!mesh.isUploaded || mesh.isEmpty || (total == 0 && !record.hasPlants)) {
+        remove(pos);
+        return;
+    }
+
+    auto [it, inserted] = indexOf.try_emplace(pos, static_cast<uint32_t>(records.size()));
+    if (inserted) {
+        records.push_back(record);
+    } else {
+        records[it->second] = record;
+    }
+}
+
+void ChunkRenderList::remove(const ChunkPosition& pos) {
+    auto it = indexOf.find(pos);
+    if (it == indexOf.end()) return;
+
+    const uint32_t index = it->second;
+    indexOf.erase(it);
+    if (index + 1 != records.size()) {
+        records[index] = records.back();
+        indexOf[records[index].position] = index;
+    }
+    records.pop_back();
+}
+
+void ChunkRenderList::clear() {
+    records.clear();
+    indexOf.clear();
+}
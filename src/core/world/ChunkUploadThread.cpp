@@ -0,0 +1,98 @@
+#include "core/world/ChunkUploadThread.h"
+
+#include <iostream>
+
+ChunkUploadThread::ChunkUploadThread() {}
+
+ChunkUploadThread::~ChunkUploadThread() {
+    stop();
+}
+
+bool ChunkUploadThread::start(GLFWwindow* mainWindow) {
+    if (running) return true;
+
+    // The other window hints are still the ones the main window was created with, so both contexts match
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    context = glfwCreateWindow(1, 1, "TerraLink upload", nullptr, mainWindow);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+    if (!context) return false;
+
+    running = true;
+    thread = std::thread(&ChunkUploadThread::run, this);
+    return true;
+}
+
+void ChunkUploadThread::stop() {
+    if (!running) return;
+
+    jobs.stop();
+    if (thread.joinable()) thread.join();
+    running = false;
+
+    written.drain(arrived);
+    for (Job& job : arrived) inFlight.push_back(std::move(job));
+    arrived.clear();
+    for (Job& job : inFlight) {
+        if (job.fence) glDeleteSync(job.fence);
+    }
+    inFlight.clear();
+
+    glfwDestroyWindow(context);
+    context = nullptr;
+}
+
+void ChunkUploadThread::queue(Job&& job) {
+    jobs.push(std::move(job));
+}
+
+void ChunkUploadThread::run() {
+    glfwMakeContextCurrent(context);
+
+    Job job;
+    while (jobs.waitPop(job)) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, job.vertexBuffer);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, job.vertexOffset, job.vertices.size() * sizeof(Vertex), job.vertices.data());
+        glBindBuffer(GL_COPY_WRITE_BUFFER, job.indexBuffer);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, job.indexOffset, job.indices.size() * sizeof(GLuint), job.indices.data());
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        // Without the flush the fence might never reach the GPU, and the main thread would wait on it forever
+        job.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+
+        std::vector<Vertex>().swap(job.vertices);
+        std::vector<GLuint>().swap(job.indices);
+        written.push(std::move(job));
+    }
+
+    glfwMakeContextCurrent(nullptr);
+}
+
+// Fences signal in the order they were inserted, so checking stops at the first one still pending.
+// Another context's writes are only guaranteed visible here once the buffers are bound again after
+// the fence signaled, so each finished job's buffers are bound once before it is handed back
+void ChunkUploadThread::collectFinished(std::vector<Job>& out) {
+    written.drain(arrived);
+    for (Job& job : arrived) inFlight.push_back(std::move(job));
+    arrived.clear();
+
+    while (!inFlight.empty()) {
+        Job& job = inFlight.front();
+        GLenum status = glClientWaitSync(job.fence, 0, 0);
+        if (status == GL_WAIT_FAILED) {
+            std::cerr << "Waiting on a chunk upload fence failed" << std::endl;
+        } else if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            break;
+        }
+
+        glDeleteSync(job.fence);
+        job.fence = nullptr;
+        // The copy targets leave the bound VAO's element buffer alone
+        glBindBuffer(GL_COPY_READ_BUFFER, job.vertexBuffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, job.indexBuffer);
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        out.push_back(std::move(job));
+        inFlight.pop_front();
+    }
+}
@@ -0,0 +1,192 @@
+#include "core/world/Cloud.h"
+
+#include <climits>
+#include <cmath>
+
+#include "noise/FastNoiseLite.h"
+
+CloudLayer::CloudLayer() {}
+
+CloudLayer::~CloudLayer() {
+    if (worker.joinable()) {
+        requests.clear();
+        requests.stop();
+        worker.join();
+    }
+}
+
+void CloudLayer::start(int cloudSeed) {
+    if (running) return;
+    seed = cloudSeed;
+
+    // Unit box, each face CCW from outside. Faces are -X, +X, -Z, +Z, -Y, +Y with axes u x v = normal
+    const glm::vec3 normals[6] = { { -1, 0, 0 }, { 1, 0, 0 }, { 0, 0, -1 }, { 0, 0, 1 }, { 0, -1, 0 }, { 0, 1, 0 } };
+    const glm::vec3 us[6] = { { 0, 0, 1 }, { 0, 1, 0 }, { 0, 1, 0 }, { 1, 0, 0 }, { 1, 0, 0 }, { 0, 0, 1 } };
+    const glm::vec3 vs[6] = { { 0, 1, 0 }, { 0, 0, 1 }, { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 }, { 1, 0, 0 } };
+    const float corners[4][2] = { { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 } };
+
+    std::vector<Vertex> boxVertices;
+    std::vector<GLuint> boxIndices;
+    for (int face = 0; face < 6; ++face) {
+        const GLuint base = static_cast<GLuint>(boxVertices.size());
+        for (const auto& corner : corners) {
+            glm::vec3 position = 0.5f + 0.5f * (normals[face] + corner[0] * us[face] + corner[1] * vs[face]);
+            boxVertices.push_back({ position, normals[face], glm::vec2(0.0f) });
+        }
+        for (GLuint index : { 0u, 1u, 2u, 0u, 2u, 3u }) boxIndices.push_back(base + index);
+    }
+
+    boxVAO.init();
+    boxVAO.bind();
+    boxVAO.addVertexBuffer(boxVertices);
+    boxVAO.addElementBuffer(boxIndices);
+    boxVAO.addAttribute(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+    boxVAO.addAttribute(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+    boxVAO.addAttribute(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoords));
+
+    // Every slot owns a fixed range of cells, so a tile moving in only rewrites its own range
+    glGenBuffers(1, &instanceBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    glBufferData(GL_ARRAY_BUFFER, CLOUD_TILE_COUNT * CLOUD_CELLS_PER_TILE * sizeof(CloudCell), nullptr, GL_DYNAMIC_DRAW);
+    glVertexAttribIPointer(3, 1, GL_UNSIGNED_INT, sizeof(CloudCell), (void*)0);
+    glVertexAttribDivisor(3, 1);
+    glEnableVertexAttribArray(3);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    boxVAO.unbind();
+
+    for (Slot& slot : slots) slot = Slot{ CloudPosition(INT_MIN, INT_MIN) };
+    tileOrigins.fill(glm::vec4(0.0f));
+
+    running = true;
+    worker = std::thread(&CloudLayer::workerThread, this);
+}
+
+void CloudLayer::stop() {
+    if (!running) return;
+
+    requests.clear();
+    requests.stop();
+    if (worker.joinable()) worker.join();
+    finished.clear();
+    running = false;
+
+    boxVAO.deleteBuffers();
+    glDeleteBuffers(1, &instanceBuffer);
+    instanceBuffer = 0;
+}
+
+// Tiles map onto slots by their position modulo the ring size, so the slot a tile needs is always
+// the one of the tile that just left the ring on the opposite side
+int CloudLayer::slotIndex(const CloudPosition& position) {
+    const int x = ((position.x % CLOUD_RING_SIZE) + CLOUD_RING_SIZE) % CLOUD_RING_SIZE;
+    const int z = ((position.y % CLOUD_RING_SIZE) + CLOUD_RING_SIZE) % CLOUD_RING_SIZE;
+    return x + z * CLOUD_RING_SIZE;
+}
+
+void CloudLayer::update(const glm::vec3& cameraPosition, float time) {
+    if (!running) return;
+
+    // The grid drifts as a whole, tiles are picked in the drifted frame so the clouds stream in around the camera
+    drift = time * CLOUD_DRIFT_SPEED;
+    const CloudPosition center(
+        static_cast<int>(std::floor((cameraPosition.x - drift) / CLOUD_TILE_SIZE)),
+        static_cast<int>(std::floor(cameraPosition.z / CLOUD_TILE_SIZE))
+    );
+
+    for (int dz = -CLOUD_RING_RADIUS; dz <= CLOUD_RING_RADIUS; ++dz) {
+        for (int dx = -CLOUD_RING_RADIUS; dx <= CLOUD_RING_RADIUS; ++dx) {
+            const CloudPosition position = center + CloudPosition(dx, dz);
+            const int index = slotIndex(position);
+            Slot& slot = slots[index];
+            if (slot.requested && slot.position == position) continue;
+
+            slot.position = position;
+            slot.requested = true;
+            slot.ready = false;
+            tileOrigins[index].w = 0.0f;
+            requests.push(position);
+        }
+    }
+
+    // Tiles for slots that have moved on since they were requested are dropped without counting
+    int uploads = 0;
+    Tile tile;
+    while (uploads < MAX_TILE_UPLOADS && finished.tryPop(tile)) {
+        const int index = slotIndex(tile.position);
+        Slot& slot = slots[index];
+        if (slot.position != tile.position || slot.ready) continue;
+
+        glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+        glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(index) * CLOUD_CELLS_PER_TILE * sizeof(CloudCell),
+                        CLOUD_CELLS_PER_TILE * sizeof(CloudCell), tile.cells.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        slot.ready = true;
+        tileOrigins[index] = glm::vec4(tile.position.x * CLOUD_TILE_SIZE, tile.position.y * CLOUD_TILE_SIZE, 0.0f, 1.0f);
+        ++uploads;
+    }
+}
+
+// Draws every cell of every slot, empty cells and slots still waiting for their tile collapse in the vertex
+// shader. The instance count is fixed, so the clouds cost the same every frame
+void CloudLayer::draw(Shader& cloudShader) {
+    if (!running) return;
+
+    cloudShader.use();
+    glUniform4fv(cloudShader.getUniformLocation("tileOrigins"), CLOUD_TILE_COUNT, &tileOrigins[0].x);
+    glUniform1f(cloudShader.getUniformLocation("drift"), drift);
+    // The camera's tile is always at least the ring radius away from the edge of the ring
+    glUniform1f(cloudShader.getUniformLocation("fadeEnd"), static_cast<float>(CLOUD_RING_RADIUS * CLOUD_TILE_SIZE));
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    boxVAO.bind();
+    glDrawElementsInstanced(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0, CLOUD_TILE_COUNT * CLOUD_CELLS_PER_TILE);
+    boxVAO.unbind();
+    glDisable(GL_BLEND);
+}
+
+void CloudLayer::workerThread() {
+    FastNoiseLite noise;
+    noise.SetSeed(seed);
+    noise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
+    noise.SetFractalType(FastNoiseLite::FractalType_FBm);
+    noise.SetFractalOctaves(3);
+    noise.SetFrequency(0.06f);
+
+    std::vector<uint8_t> occupied;
+    CloudPosition position;
+    while (requests.waitPop(position)) {
+        Tile tile;
+        generateTile(noise, position, tile, occupied);
+        finished.push(std::move(tile));
+    }
+}
+
+// Samples the noise for the tile plus a ring of cells around it, so sides covered by a cell in the next tile
+// are known without waiting for that tile
+void CloudLayer::generateTile(const FastNoiseLite& noise, const CloudPosition& position, Tile& tile, std::vector<uint8_t>& occupied) {
+    constexpr int SIDE = CLOUD_TILE_CELLS + 2;
+    occupied.assign(SIDE * SIDE, 0);
+    const int firstX = position.x * CLOUD_TILE_CELLS - 1;
+    const int firstZ = position.y * CLOUD_TILE_CELLS - 1;
+    for (int z = 0; z < SIDE; ++z) {
+        for (int x = 0; x < SIDE; ++x) {
+            occupied[x + z * SIDE] = noise.GetNoise(static_cast<float>(firstX + x), static_cast<float>(firstZ + z)) > 0.2f;
+        }
+    }
+
+    tile.position = position;
+    for (int z = 0; z < CLOUD_TILE_CELLS; ++z) {
+        for (int x = 0; x < CLOUD_TILE_CELLS; ++x) {
+            const int idx = (x + 1) + (z + 1) * SIDE;
+            CloudCell cell = static_cast<CloudCell>(x) | (static_cast<CloudCell>(z) << 4);
+            if (occupied[idx]) {
+                const CloudCell sides = (occupied[idx - 1] ? 1u : 0u) | (occupied[idx + 1] ? 2u : 0u)
+                                      | (occupied[idx - SIDE] ? 4u : 0u) | (occupied[idx + SIDE] ? 8u : 0u);
+                cell |= (1u << 8) | (sides << 9);
+            }
+            tile.cells[x + z * CLOUD_TILE_CELLS] = cell;
+        }
+    }
+}
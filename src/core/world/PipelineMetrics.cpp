@@ -0,0 +1,78 @@
+#include "core/world/PipelineMetrics.h"
+
+#include <cstdio>
+
+PipelineMetrics& PipelineMetrics::instance() {
+    static PipelineMetrics metrics;
+    return metrics;
+}
+
+// Records a full chunk mesh and how many buffers had to be (re)allocated for it
+void PipelineMetrics::recordMesh(int lodLevel, int allocations, int64_t microseconds) {
+    meshes.fetch_add(1, std::memory_order_relaxed);
+    if (lodLevel > 0) lodMeshes.fetch_add(1, std::memory_order_relaxed);
+    meshAllocations.fetch_add(allocations, std::memory_order_relaxed);
+    meshMicroseconds.fetch_add(static_cast<uint64_t>(microseconds), std::memory_order_relaxed);
+}
+
+void PipelineMetrics::recordPartialRemesh(int allocations) {
+    partialRemeshes.fetch_add(1, std::memory_order_relaxed);
+    meshAllocations.fetch_add(allocations, std::memory_order_relaxed);
+}
+
+void PipelineMetrics::setTrackingLoadLatency(bool enable) {
+    std::lock_guard<std::mutex> lock(latencyMutex);
+    trackingLoadLatency = enable;
+    requestTimes.clear();
+    loadLatencies.clear();
+}
+
+// A position queued again after being drained restarts its timer, the earlier request never finished
+void PipelineMetrics::recordChunkRequested(const ChunkPosition& pos) {
+    if (!trackingLoadLatency.load(std::memory_order_relaxed)) return;
+    std::lock_guard<std::mutex> lock(latencyMutex);
+    requestTimes[pos] = std::chrono::steady_clock::now();
+}
+
+void PipelineMetrics::recordChunkRequestDropped(const ChunkPosition& pos) {
+    if (!trackingLoadLatency.load(std::memory_order_relaxed)) return;
+    std::lock_guard<std::mutex> lock(latencyMutex);
+    requestTimes.erase(pos);
+}
+
+void PipelineMetrics::recordChunkDrawable(const ChunkPosition& pos) {
+    if (!trackingLoadLatency.load(std::memory_order_relaxed)) return;
+    std::lock_guard<std::mutex> lock(latencyMutex);
+    auto it = requestTimes.find(pos);
+    if (it == requestTimes.end()) return;
+
+    loadLatencies.push_back(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - it->second).count());
+    requestTimes.erase(it);
+}
+
+// Milliseconds per chunk in the order they became drawable
+std::vector<float> PipelineMetrics::getLoadLatencies() const {
+    std::lock_guard<std::mutex> lock(latencyMutex);
+    return loadLatencies;
+}
+
+std::string PipelineMetrics::summary() const {
+    uint64_t meshCount = getMeshCount();
+    uint64_t remeshCount = getPartialRemeshCount();
+    uint64_t total = meshCount + remeshCount;
+
+    double allocsPerMesh = total > 0 ? static_cast<double>(getMeshAllocationCount()) / total : 0.0;
+    double msPerMesh = meshCount > 0 ? meshMicroseconds.load(std::memory_order_relaxed) / 1000.0 / meshCount : 0.0;
+
+    // Partial remeshes include border remeshes, every mesh and remesh counts against the chunks loaded
+    uint64_t chunkCount = getChunksLoadedCount();
+    double remeshesPerChunk = chunkCount > 0 ? static_cast<double>(total) / chunkCount : 0.0;
+
+    char buffer[224];
+    std::snprintf(buffer, sizeof(buffer), "meshes %llu (lod %llu, partial %llu, border %llu)  //  %.2f meshes/chunk  //  %.2f allocs/mesh  //  %.2f ms/mesh",
+                  static_cast<unsigned long long>(meshCount), static_cast<unsigned long long>(getLodMeshCount()),
+                  static_cast<unsigned long long>(remeshCount), static_cast<unsigned long long>(getBorderRemeshCount()),
+                  remeshesPerChunk, allocsPerMesh, msPerMesh);
+
+    return buffer;
+}
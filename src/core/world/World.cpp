@@ -1,5 +1,8 @@
 #include "core/world/World.h"
+#include "core/world/ChunkMesher.h"
+#include "core/world/PipelineMetrics.h"
 #include "core/player/Player.h"
+#include "core/game/Game.h"
 #include "network/Network.h"
 #include "network/UDPSocket.h"
 #include "network/Serializer.h"
@@ -34,6 +37,7 @@ void World::shutdown() {
     chunkUploadQueue.stop();
     meshUpdateQueue.stop();
     chunkSaveQueue.stop();
+    borderRemeshQueue.stop();
 
     std::cout << "\nJoining chunk generation threads..." << std::endl;
     for (auto& thread : chunkGenThreads) if (thread.joinable()) thread.join();
@@ -58,7 +62,9 @@ void World::shutdown() {
 
         if (chunk->mesh.isUploaded) {
             try {
-                chunk->mesh.VAO.deleteBuffers();
+                ChunkBufferArena::instance().release(chunk->mesh.arenaHandle);
+                chunk->mesh.faceRecordBuffer.deleteBuffers();
+                chunk->mesh.plantInstanceBuffer.deleteBuffers();
             } catch (...) {
                 std::cerr << "Exception in deleteBuffers for chunk at " << pos.x << ", " << pos.y << ", " << pos.z << std::endl;
             }
@@ -66,9 +72,16 @@ void World::shutdown() {
         }
         chunk->mesh.vertices.clear();
         chunk->mesh.indices.clear();
+        chunk->mesh.faceRecords.clear();
+        chunk->mesh.plantInstances.clear();
     }
 
     chunks.clear();
+    renderList.clear();
+    {
+        std::lock_guard<std::mutex> lock(generatedChunksMutex);
+        generatedChunks.clear();
+    }
 
     if (!NetworkManager::instance().isOnlineMode() || NetworkManager::instance().isHost()) {
         std::cout << "Saving player data..." << std::endl;
@@ -147,6 +160,7 @@ void World::chunkUpdateThread() {
                     }
 
                     std::shared_ptr<Chunk> chunk = deserializeChunk(decompressed);
+                    registerGeneratedChunk(chunk);
                     meshUploadQueue.push(chunk);
         
                 }
@@ -162,10 +176,14 @@ void World::chunkUpdateThread() {
 // Thread function for loading chunks around the player
 void World::managerThread() {
     glm::ivec3 lastChunkPos = {INT_MAX, 0, INT_MAX};
+    int lastViewDistance = 0;
     while (running) {
         auto current = Player::instance().getChunkPosition();
-        if (current.x != lastChunkPos.x || current.z != lastChunkPos.z) {
+        const int viewDistance = Player::instance().getViewDistance();
+        // A changed view distance requeues like a move, so a shrinking one drops the far chunks still waiting
+        if (current.x != lastChunkPos.x || current.z != lastChunkPos.z || viewDistance != lastViewDistance) {
             lastChunkPos = current;
+            lastViewDistance = viewDistance;
 
             std::vector<ChunkPosition> drainedCreation;
             std::vector<std::shared_ptr<Chunk>> drainedMesh;
@@ -176,9 +194,9 @@ void World::managerThread() {
             for (const auto& pos : drainedCreation) chunkPositionSet.erase(pos);
             for (const auto& chunk : drainedMesh) chunkPositionSet.erase(chunk->getPosition());
 
-            updateChunksAroundPlayer(current, Player::instance().getViewDistance());
+            updateChunksAroundPlayer(current, viewDistance);
         }
-        queueChunksForRemoval(current, Player::instance().getViewDistance() + 1);
+        queueChunksForRemoval(current, viewDistance + 1);
 
         SavableChunk savableChunk;
         while (chunkSaveQueue.tryPop(savableChunk)) {
@@ -187,6 +205,11 @@ void World::managerThread() {
             chunk->setBlocks(savableChunk.blocks);
             chunk->mesh.vertices = savableChunk.vertices;
             chunk->mesh.indices = savableChunk.indices;
+            chunk->mesh.cellRanges = savableChunk.cellRanges;
+            chunk->mesh.hasCellRanges = savableChunk.hasCellRanges;
+            chunk->mesh.lodLevel = savableChunk.lodLevel;
+            chunk->mesh.meshedNeighbors = savableChunk.meshedNeighbors;
+            chunk->mesh.plantsInstanced = savableChunk.plantsInstanced;
 
             chunk->mesh.isEmpty = chunk->mesh.vertices.empty() && chunk->mesh.indices.empty();
 
@@ -206,25 +229,39 @@ void World::chunkWorkerThread() {
         ChunkPosition pos;
         if (!chunkCreationQueue.waitPop(pos)) return;
 
-        if ((pos.y * CHUNK_SIZE + CHUNK_SIZE) < MIN_GENERATE_Y) continue;
+        if ((pos.y * CHUNK_SIZE + CHUNK_SIZE) < MIN_GENERATE_Y) {
+            PipelineMetrics::instance().recordChunkRequestDropped(pos);
+            continue;
+        }
 
         std::shared_ptr<Chunk> chunk = std::make_shared<Chunk>();
 
         if (NetworkManager::instance().isOnlineMode() && NetworkManager::instance().isClient()) {
             if (requestChunkOverUDP(pos, chunk)) {
+                registerGeneratedChunk(chunk);
                 meshUploadQueue.push(chunk);
             } else {
                 chunk->generateTerrain();
+                registerGeneratedChunk(chunk);
                 meshGenerationQueue.push(chunk);
             }
             continue;
 
         } else if (loadChunkFromFile(pos, chunk)) {
-            meshUploadQueue.push(chunk);
+            registerGeneratedChunk(chunk);
+            // Saved meshes are only reused at the level of detail they were built for, and face records are never saved.
+            // Meshes saved with plants baked in, or left out, are rebuilt when that no longer matches
+            const bool plantsChanged = chunk->mesh.plantsInstanced != BlockRegister::instance().getMeshTable().instancedPlants;
+            if (plantsChanged || (!chunk->mesh.isEmpty && (chunk->mesh.lodLevel != lodLevelForChunk(pos) || wantsFaceRecords(chunk->mesh.lodLevel)))) {
+                meshGenerationQueue.push(chunk);
+            } else {
+                meshUploadQueue.push(chunk);
+            }
 
         } else {
             chunk->setPosition(pos);
             chunk->generateTerrain();
+            registerGeneratedChunk(chunk);
             meshGenerationQueue.push(chunk);
         }
     }
@@ -236,105 +273,370 @@ void World::meshWorkerThread() {
     while (running) {
         std::shared_ptr<Chunk> chunk;
 
-        if (!meshUpdateQueue.tryPop(chunk)) {
-            if (!meshGenerationQueue.tryPop(chunk)) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
-                continue;
-            }
+        const bool remesh = meshUpdateQueue.tryPop(chunk);
+        if (!remesh && !meshGenerationQueue.tryPop(chunk)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
         }
         if (!chunk) continue;
+
+        bool meshed = false;
         if (chunk->mesh.isEmpty) {
             chunkUploadQueue.push(chunk);
-            continue;
+        } else if (chunk->mesh.needsUpdate || !chunk->mesh.isUploaded) {
+            const glm::ivec3 playerChunk = Player::instance().getChunkPosition();
+            if (isColumnInViewRange(chunk->getPosition().x - playerChunk.x, chunk->getPosition().z - playerChunk.z,
+                                    viewRadiusBlocks(Player::instance().getViewDistance()))) {
+                generateMesh(chunk);
+                meshed = true;
+            }
         }
-        if (!chunk->mesh.needsUpdate && chunk->mesh.isUploaded) continue;
-        if (std::abs(chunk->getPosition().x - Player::instance().getChunkPosition().x) > Player::instance().getViewDistance() ||
-            std::abs(chunk->getPosition().z - Player::instance().getChunkPosition().z) > Player::instance().getViewDistance()) {
-            continue;
+
+        // The chunk can be queued again once it is out of the worker, edits made while it was meshing queue it right away
+        if (remesh) {
+            chunk->mesh.remeshQueued = false;
+            if (meshed && chunk->mesh.needsUpdate) queueRemesh(chunk);
         }
-        generateMesh(chunk);
     }
 }
 
+void World::queueRemesh(const std::shared_ptr<Chunk>& chunk) {
+    chunk->mesh.needsUpdate = true;
+    if (!chunk->mesh.remeshQueued.exchange(true)) meshUpdateQueue.push(chunk);
+}
+
 // Generates the mesh for a chunk based on the task provided
 void World::generateMesh(const std::shared_ptr<Chunk>& chunk) {
-    std::vector<Vertex> vertices;
-    std::vector<GLuint> indices;
-    
-    chunk->generateMesh(vertices, indices,
-        [this, chunk](glm::ivec3 offset, int x, int y, int z) -> int {
-            int nx = x + offset.x;
-            int ny = y + offset.y;
-            int nz = z + offset.z;
-    
-            int worldX = chunk->getPosition().x * CHUNK_SIZE + nx;
-            int worldY = chunk->getPosition().y * CHUNK_SIZE + ny;
-            int worldZ = chunk->getPosition().z * CHUNK_SIZE + nz;
-    
-            return 0;
-        });
-    
-    if (!chunk->mesh.isEmpty && chunk->mesh.needsUpdate) {
-        chunk->mesh.stagingVertices = std::move(vertices);
-        chunk->mesh.stagingIndices = std::move(indices);
-        chunk->mesh.hasNewMesh = true;
-        chunk->mesh.isEmpty = chunk->mesh.stagingVertices.empty() && chunk->mesh.stagingIndices.empty();
+    auto start = std::chrono::steady_clock::now();
+
+    // Every worker meshes into its own buffers and swaps them into the chunk only once it is done, so nothing
+    // the main thread or another worker can touch is written while meshing. The swap hands the worker the
+    // storage of the mesh replaced last time, so the buffers stop growing once they are large enough
+    thread_local std::vector<Vertex> vertices;
+    thread_local std::vector<GLuint> indices;
+    thread_local std::vector<uint32_t> faceRecords;
+    thread_local std::vector<uint32_t> plantInstances;
+    vertices.clear();
+    indices.clear();
+    faceRecords.clear();
+    plantInstances.clear();
+
+    // Remeshes go to the staging buffers, the uploaded mesh keeps drawing until the main thread swaps them in.
+    // needsUpdate is cleared before the blocks are read, so an edit from here on sets it again
+    const bool useStaging = !chunk->mesh.isEmpty && chunk->mesh.needsUpdate;
+    chunk->mesh.needsUpdate = false;
+
+    const size_t vertexCapacity = vertices.capacity();
+    const size_t indexCapacity = indices.capacity();
 
+    MeshCellRanges cellRanges;
+    PlantInstanceCounts plantCounts = {};
+    uint8_t meshedNeighbors = ALL_NEIGHBORS;
+    int lodLevel = lodLevelForChunk(chunk->getPosition());
+    if (lodLevel > 0) {
+        chunk->generateLodMesh(vertices, indices, lodLevel, &cellRanges);
     } else {
-        chunk->mesh.vertices = std::move(vertices);
-        chunk->mesh.indices = std::move(indices);
-        chunk->mesh.isEmpty = chunk->mesh.vertices.empty() && chunk->mesh.indices.empty();
+        ChunkNeighborAccessor neighbors = makeNeighborAccessor(chunk->getPosition());
+        chunk->generateMesh(vertices, indices, neighbors, &cellRanges);
+        if (wantsFaceRecords(lodLevel)) chunk->generateFaceRecords(faceRecords, neighbors);
+        chunk->generatePlantInstances(plantInstances, plantCounts);
+        meshedNeighbors = neighbors.knownNeighbors;
+    }
+    const bool emptyMesh = vertices.empty() && indices.empty() && plantInstances.empty();
+
+    int allocations = (vertices.capacity() != vertexCapacity ? 1 : 0) + (indices.capacity() != indexCapacity ? 1 : 0);
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    PipelineMetrics::instance().recordMesh(lodLevel, allocations, elapsed.count());
+
+    {
+        ChunkMesh& mesh = chunk->mesh;
+        std::lock_guard<std::mutex> lock(mesh.stagingMutex);
+        mesh.plantsInstanced = BlockRegister::instance().getMeshTable().instancedPlants;
+        if (useStaging) {
+            mesh.stagingVertices.swap(vertices);
+            mesh.stagingIndices.swap(indices);
+            mesh.stagingFaceRecords.swap(faceRecords);
+            mesh.stagingPlantInstances.swap(plantInstances);
+            mesh.stagingCellRanges = cellRanges;
+            mesh.stagingLodLevel = lodLevel;
+            mesh.stagingMeshedNeighbors = meshedNeighbors;
+            mesh.stagingPlantCounts = plantCounts;
+            mesh.hasNewMesh = true;
+        } else {
+            mesh.vertices.swap(vertices);
+            mesh.indices.swap(indices);
+            mesh.faceRecords.swap(faceRecords);
+            mesh.plantInstances.swap(plantInstances);
+            mesh.cellRanges = cellRanges;
+            mesh.hasCellRanges = true;
+            mesh.lodLevel = lodLevel;
+            mesh.meshedNeighbors = meshedNeighbors;
+            mesh.plantCounts = plantCounts;
+        }
+        mesh.isEmpty = emptyMesh;
     }
-    
-    chunk->mesh.needsUpdate = false;
 
-    if (!chunk->mesh.isEmpty) {
+    // A remesh that came out empty goes through the upload queue as well, the old mesh is swapped out
+    // and its buffers freed on the main thread
+    if (!chunk->mesh.isEmpty || chunk->mesh.hasNewMesh) {
         meshUploadQueue.push(chunk);
-    } else if (chunk->mesh.isUploaded && chunk->mesh.hasNewMesh) {
-        chunk->mesh.VAO.deleteBuffers();
-        chunk->mesh.isUploaded = false;
-        chunk->mesh.vertices = std::move(chunk->mesh.stagingVertices);
-        chunk->mesh.indices  = std::move(chunk->mesh.stagingIndices);
-        chunk->mesh.stagingIndices.clear();
-        chunk->mesh.stagingVertices.clear();
     }
 
+    // LOD meshes stay local, peers may be close enough to need full resolution
+    if (lodLevel > 0) return;
     if (NetworkManager::instance().isOnlineMode() && (!chunk->mesh.isEmpty || chunk->mesh.hasNewMesh)) sendChunkOverUDP(chunk->makeSavableCopy());
 }
 
-// Sets a block at the specified world position
-void World::setBlockAtWorldPosition(int wx, int wy, int wz, int blockID) {
-    ChunkPosition chunkPos = {
+// Makes a chunk's blocks visible to the meshing of its neighbors, and queues border remeshes for
+// neighbors that were meshed before it existed
+void World::registerGeneratedChunk(const std::shared_ptr<Chunk>& chunk) {
+    const ChunkPosition pos = chunk->getPosition();
+
+    std::lock_guard<std::mutex> lock(generatedChunksMutex);
+    generatedChunks[pos] = chunk;
+
+    for (int face = 0; face < 6; ++face) {
+        ChunkPosition neighborPos = { pos.x + FACE_OFFSETS[face].x, pos.y + FACE_OFFSETS[face].y, pos.z + FACE_OFFSETS[face].z };
+        if (generatedChunks.find(neighborPos) == generatedChunks.end()) continue;
+        queueBorderRemesh(neighborPos, oppositeFace(face), false);
+    }
+
+    PipelineMetrics::instance().recordChunkLoaded();
+}
+
+void World::unregisterGeneratedChunk(const ChunkPosition& pos) {
+    std::lock_guard<std::mutex> lock(generatedChunksMutex);
+    generatedChunks.erase(pos);
+}
+
+// Looks up the six neighbors of a chunk. Neighbors meshed at a lower level of detail are left out
+// so the faces towards them stay and cover the difference in shape
+ChunkNeighborAccessor World::makeNeighborAccessor(const ChunkPosition& pos) const {
+    ChunkNeighborAccessor accessor;
+
+    std::lock_guard<std::mutex> lock(generatedChunksMutex);
+    for (int face = 0; face < 6; ++face) {
+        ChunkPosition neighborPos = { pos.x + FACE_OFFSETS[face].x, pos.y + FACE_OFFSETS[face].y, pos.z + FACE_OFFSETS[face].z };
+        auto it = generatedChunks.find(neighborPos);
+        if (it == generatedChunks.end()) continue;
+
+        accessor.knownNeighbors |= 1 << face;
+        if (lodLevelForChunk(neighborPos) == 0) accessor.neighbors[face] = it->second;
+    }
+    return accessor;
+}
+
+// Queues border remeshes for neighbors that arrived while this chunk was being meshed
+void World::queueMissingNeighborRemeshes(const Chunk& chunk) {
+    if (!chunk.mesh.isUploaded || chunk.mesh.meshedNeighbors == ALL_NEIGHBORS) return;
+
+    const ChunkPosition pos = chunk.getPosition();
+
+    std::lock_guard<std::mutex> lock(generatedChunksMutex);
+    for (int face = 0; face < 6; ++face) {
+        if (chunk.mesh.meshedNeighbors & (1 << face)) continue;
+
+        ChunkPosition neighborPos = { pos.x + FACE_OFFSETS[face].x, pos.y + FACE_OFFSETS[face].y, pos.z + FACE_OFFSETS[face].z };
+        if (generatedChunks.find(neighborPos) == generatedChunks.end()) continue;
+        queueBorderRemesh(pos, face, false);
+    }
+}
+
+// Queues one border face of a chunk. A face already waiting is not queued again, a forced request
+// upgrades the waiting one instead
+void World::queueBorderRemesh(const ChunkPosition& pos, int face, bool force) {
+    std::lock_guard<std::mutex> lock(borderRemeshMutex);
+    PendingBorderFaces& pending = pendingBorderRemeshes[pos];
+    if (force) pending.forced |= 1 << face;
+    if (pending.queued & (1 << face)) return;
+
+    pending.queued |= 1 << face;
+    borderRemeshQueue.push({ pos, face });
+}
+
+// Clears a popped face from the pending masks, returns whether it was forced
+bool World::takeBorderRemesh(const BorderRemesh& task) {
+    std::lock_guard<std::mutex> lock(borderRemeshMutex);
+    auto it = pendingBorderRemeshes.find(task.position);
+    if (it == pendingBorderRemeshes.end()) return false;
+
+    const bool force = it->second.forced & (1 << task.face);
+    it->second.queued &= ~(1 << task.face);
+    it->second.forced &= ~(1 << task.face);
+    if (it->second.queued == 0) pendingBorderRemeshes.erase(it);
+    return force;
+}
+
+// Remeshes only the border cells facing a neighbor that arrived after the chunk was meshed. Chunks still
+// in the mesh workers are skipped, their upload checks their neighbors again. Only faces that are actually
+// remeshed count against the budget, stale tasks are dropped for free
+void World::processBorderRemeshes(int maxPerFrame) {
+    BorderRemesh task;
+    int remeshed = 0;
+    while (remeshed < maxPerFrame && borderRemeshQueue.tryPop(task)) {
+        const bool force = takeBorderRemesh(task);
+
+        auto it = chunks.find(task.position);
+        if (it == chunks.end() || !it->second) continue;
+
+        const std::shared_ptr<Chunk>& chunk = it->second;
+        if (!chunk->mesh.isUploaded || chunk->mesh.isEmpty || chunk->mesh.lodLevel != 0) continue;
+        if (chunk->mesh.needsUpdate || chunk->mesh.hasNewMesh || chunk->mesh.remeshQueued) continue;
+        if (!force && (chunk->mesh.meshedNeighbors & (1 << task.face))) continue;
+
+        PipelineMetrics::instance().recordBorderRemesh();
+        remeshDirtyCells(chunk, meshBorderCells(task.face), 1 << task.face);
+        ++remeshed;
+    }
+}
+
+// Level of detail a chunk should be meshed at given its distance to the player
+int World::lodLevelForChunk(const ChunkPosition& pos) const {
+    const glm::ivec3 playerChunk = Player::instance().getChunkPosition();
+    int distance = std::max(std::abs(pos.x - playerChunk.x), std::abs(pos.z - playerChunk.z));
+    return Game::instance().getLodLevelForDistance(distance);
+}
+
+// Requeues uploaded chunks whose mesh LOD no longer matches their distance, the old mesh keeps
+// drawing until the mesh workers replace it so switching never leaves holes
+void World::updateChunkLods() {
+    const glm::ivec3 current = Player::instance().getChunkPosition();
+    if (current.x == lastLodCenter.x && current.z == lastLodCenter.z) return;
+    lastLodCenter = current;
+
+    for (auto& [pos, chunk] : chunks) {
+        if (!chunk || !chunk->mesh.isUploaded || chunk->mesh.isEmpty) continue;
+        if (chunk->mesh.needsUpdate || chunk->mesh.hasNewMesh) continue;
+        if (chunk->mesh.lodLevel == lodLevelForChunk(pos)) continue;
+
+        queueRemesh(chunk);
+    }
+}
+
+// Face records are only built for full resolution meshes while the vertex pulling renderer is selected
+bool World::wantsFaceRecords(int lodLevel) const {
+    return lodLevel == 0 && Game::instance().getChunkRenderMode() == ChunkRenderMode::VERTEX_PULLING
+        && BlockRegister::instance().getMeshTable().fitsFaceRecords;
+}
+
+// Requeues every uploaded chunk for a full remesh after the renderer changed, the current meshes keep
+// drawing through their old path until they are replaced
+void World::remeshUploadedChunks() {
+    for (auto& [pos, chunk] : chunks) {
+        if (!chunk || !chunk->mesh.isUploaded || chunk->mesh.isEmpty) continue;
+        if (chunk->mesh.needsUpdate || chunk->mesh.hasNewMesh) continue;
+
+        queueRemesh(chunk);
+    }
+}
+
+// Splits a world position into its chunk position and the local block position inside that chunk
+static void worldToChunkLocal(int wx, int wy, int wz, ChunkPosition& chunkPos, glm::ivec3& local) {
+    chunkPos = {
         (wx < 0 && wx % CHUNK_SIZE != 0) ? (wx / CHUNK_SIZE - 1) : (wx / CHUNK_SIZE),
         (wy < 0 && wy % CHUNK_SIZE != 0) ? (wy / CHUNK_SIZE - 1) : (wy / CHUNK_SIZE),
         (wz < 0 && wz % CHUNK_SIZE != 0) ? (wz / CHUNK_SIZE - 1) : (wz / CHUNK_SIZE)
-    };    
-
-    int localX = wx % CHUNK_SIZE;
-    int localY = wy % CHUNK_SIZE;
-    int localZ = wz % CHUNK_SIZE;
+    };
 
-    if (localX < 0) localX += CHUNK_SIZE;
-    if (localY < 0) localY += CHUNK_SIZE;
-    if (localZ < 0) localZ += CHUNK_SIZE;
+    local = glm::ivec3(wx - chunkPos.x * CHUNK_SIZE, wy - chunkPos.y * CHUNK_SIZE, wz - chunkPos.z * CHUNK_SIZE);
+}
 
-    std::shared_ptr<Chunk> chunk;
+// Sets a block at the specified world position
+void World::setBlockAtWorldPosition(int wx, int wy, int wz, int blockID) {
+    ChunkPosition chunkPos;
+    glm::ivec3 local;
+    worldToChunkLocal(wx, wy, wz, chunkPos, local);
 
     auto it = chunks.find(chunkPos);
-    if (it == chunks.end()) {
-        std::shared_ptr<Chunk> newChunk = std::make_shared<Chunk>();
-        newChunk->setPosition(chunkPos);
-        chunk = newChunk;
-    } else {
-        chunk = it->second;
+    if (it == chunks.end() || !it->second) {
+        std::shared_ptr<Chunk> chunk = std::make_shared<Chunk>();
+        chunk->setPosition(chunkPos);
+        chunk->setBlockID(local.x, local.y, local.z, blockID);
+        chunk->updateVisibility();
+        chunk->mesh.isEmpty = false;
+        chunk->mesh.isUploaded = true;
+        queueRemesh(chunk);
+        return;
     }
 
-    chunk->setBlockID(localX, localY, localZ, blockID);
-    chunk->mesh.isEmpty = false;
-    chunk->mesh.isUploaded = true;   
+    it->second->setBlockID(local.x, local.y, local.z, blockID);
+    it->second->updateVisibility();
 
-    chunk->mesh.needsUpdate = true;
-    meshUpdateQueue.push(chunk);
+    // The edit also changes the faces of its six neighbors, which can sit in other cells or other chunks
+    std::vector<std::pair<ChunkPosition, uint64_t>> dirty;
+    dirty.emplace_back(chunkPos, 1ull << meshCellIndex(local.x, local.y, local.z));
+
+    for (int face = 0; face < 6; ++face) {
+        ChunkPosition neighborPos;
+        glm::ivec3 neighborLocal;
+        worldToChunkLocal(wx + FACE_OFFSETS[face].x, wy + FACE_OFFSETS[face].y, wz + FACE_OFFSETS[face].z, neighborPos, neighborLocal);
+
+        uint64_t cell = 1ull << meshCellIndex(neighborLocal.x, neighborLocal.y, neighborLocal.z);
+        auto entry = std::find_if(dirty.begin(), dirty.end(), [&](const auto& d) { return d.first == neighborPos; });
+        if (entry != dirty.end()) {
+            entry->second |= cell;
+        } else {
+            dirty.emplace_back(neighborPos, cell);
+        }
+    }
+
+    for (const auto& [pos, cells] : dirty) {
+        auto chunkIt = chunks.find(pos);
+        if (chunkIt == chunks.end() || !chunkIt->second) continue;
+        remeshDirtyCells(chunkIt->second, cells);
+    }
+}
+
+// Remeshes only the dirty cells of an uploaded chunk and patches its GPU buffers in the same frame,
+// LOD chunks, chunks without a known cell layout or with a remesh already in flight fall back to a full remesh.
+// resolvedNeighbors marks the faces whose border cells are all part of dirtyCells
+void World::remeshDirtyCells(const std::shared_ptr<Chunk>& chunk, uint64_t dirtyCells, uint8_t resolvedNeighbors) {
+    ChunkMesh& mesh = chunk->mesh;
+
+    // A chunk already queued or with a worker only has needsUpdate set, the worker queues it again when it is done
+    if (!mesh.isUploaded || !mesh.hasCellRanges || mesh.lodLevel != 0 || mesh.hasNewMesh || mesh.needsUpdate
+        || mesh.remeshQueued || mesh.pendingArenaHandle != INVALID_ARENA_HANDLE) {
+        mesh.isEmpty = false;
+        mesh.isUploaded = true;
+        queueRemesh(chunk);
+        return;
+    }
+
+    size_t oldIndexCount = mesh.indices.size();
+    size_t vertexCapacity = mesh.vertices.capacity();
+    size_t indexCapacity = mesh.indices.capacity();
+    ChunkNeighborAccessor neighbors = makeNeighborAccessor(chunk->getPosition());
+    size_t firstChanged = chunk->remeshCells(dirtyCells, neighbors);
+    mesh.meshedNeighbors |= resolvedNeighbors & neighbors.knownNeighbors;
+
+    int allocations = (mesh.vertices.capacity() != vertexCapacity ? 1 : 0) + (mesh.indices.capacity() != indexCapacity ? 1 : 0);
+    PipelineMetrics::instance().recordPartialRemesh(allocations);
+
+    // Plants are a few bytes each and do not depend on neighbors, so they are rebuilt whole like face records
+    mesh.plantInstances.clear();
+    chunk->generatePlantInstances(mesh.plantInstances, mesh.plantCounts);
+    uploadPlantInstances(mesh);
+    mesh.isEmpty = mesh.vertices.empty() && mesh.indices.empty() && mesh.plantInstances.empty();
+
+    // Records are 4 bytes per quad, so rebuilding and resending all of them is cheaper than splicing
+    if (mesh.faceRecordBuffer.isInitialized()) {
+        mesh.faceRecords.clear();
+        chunk->generateFaceRecords(mesh.faceRecords, neighbors);
+        if (!mesh.faceRecords.empty()) {
+            mesh.faceRecordBuffer.upload(mesh.faceRecords.data(), mesh.faceRecords.size() * sizeof(uint32_t), GL_R32UI, GL_DYNAMIC_DRAW);
+        } else {
+            mesh.faceRecordBuffer.deleteBuffers();
+        }
+    } else {
+        uploadMeshRange(*chunk, firstChanged, oldIndexCount);
+    }
+    renderList.update(chunk);
+
+    if (NetworkManager::instance().isOnlineMode()) {
+        SavableChunk update = chunk->makeSavableCopy();
+        update.hasMeshUpdate = true;
+        sendChunkOverUDP(update);
+    }
 }
 
 // Updates the chunks around the player based on their position
@@ -351,17 +653,20 @@ void World::updateChunksAroundPlayer(const glm::ivec3& playerChunk, const int VI
 
             if (chunkPositionSet.find(pos) != chunkPositionSet.end()) continue;
             chunkPositionSet.insert(pos);
+            PipelineMetrics::instance().recordChunkRequested(pos);
             chunkCreationQueue.push(pos);
         }
     }
 }
 
+// Column offsets inside the view circle for a view distance, nearest first
 std::vector<glm::ivec2> World::generateSortedOffsets(int radius) {
     std::vector<glm::ivec2> result;
+    const float radiusBlocks = viewRadiusBlocks(radius);
 
     for (int dz = -radius; dz <= radius; ++dz) {
         for (int dx = -radius; dx <= radius; ++dx) {
-            result.emplace_back(dx, dz);
+            if (isColumnInViewRange(dx, dz, radiusBlocks)) result.emplace_back(dx, dz);
         }
     }
 
@@ -374,46 +679,202 @@ std::vector<glm::ivec2> World::generateSortedOffsets(int radius) {
 
 // Uploads the chunk meshes to the GPU
 void World::uploadChunkMeshes(int maxPerFrame) {
-    for (int i = 0; i < maxPerFrame; ++i) {
+    collectThreadedUploads();
+
+    // Only uploads count against the budget. Chunks pushed back below would come around again, so the loop
+    // looks at no more entries than were queued when it started
+    size_t remaining = meshUploadQueue.size();
+    int uploads = 0;
+    while (uploads < maxPerFrame && remaining > 0) {
+        --remaining;
         std::shared_ptr<Chunk> chunk;
-        if (!meshUploadQueue.tryPop(chunk) || !chunk || (chunk->mesh.isUploaded && !chunk->mesh.hasNewMesh)) continue;
+        if (!meshUploadQueue.tryPop(chunk)) break;
+        if (!chunk || (chunk->mesh.isUploaded && !chunk->mesh.hasNewMesh)) continue;
+
+        // A newer mesh waits until the upload thread is done with the previous one
+        if (chunk->mesh.pendingArenaHandle != INVALID_ARENA_HANDLE) {
+            meshUploadQueue.push(chunk);
+            continue;
+        }
+
         try {
+            const bool wasUploaded = chunk->mesh.isUploaded;
+            const int previousLod = chunk->mesh.lodLevel;
+
+            ++uploads;
+            if (uploadThread && queueThreadedUpload(chunk, wasUploaded, previousLod)) continue;
             uploadMeshToGPU(*chunk);
-            chunk->mesh.needsUpdate = false;
-            chunk->mesh.isUploaded = true;
-            chunkUploadQueue.push(chunk);
+            finishMeshUpload(chunk, wasUploaded, previousLod);
         } catch (...) {
             std::cerr << "Mesh upload error\n";
         }
     }
 }
 
+// Marks a chunk's new mesh as drawable and hands the chunk on to the map
+void World::finishMeshUpload(const std::shared_ptr<Chunk>& chunk, bool wasUploaded, int previousLod) {
+    chunk->mesh.isUploaded = true;
+    renderList.update(chunk);
+    chunkUploadQueue.push(chunk);
+
+    PipelineMetrics::instance().recordMeshUpload(chunk->mesh.getGpuBytes());
+    if (!wasUploaded) PipelineMetrics::instance().recordChunkDrawable(chunk->getPosition());
+
+    // Neighbors read LOD chunks as air, so entering or leaving full resolution moves their border faces
+    if (wasUploaded && previousLod != chunk->mesh.lodLevel && (previousLod == 0 || chunk->mesh.lodLevel == 0)) {
+        const ChunkPosition pos = chunk->getPosition();
+        for (int face = 0; face < 6; ++face) {
+            ChunkPosition neighborPos = { pos.x + FACE_OFFSETS[face].x, pos.y + FACE_OFFSETS[face].y, pos.z + FACE_OFFSETS[face].z };
+            queueBorderRemesh(neighborPos, oppositeFace(face), true);
+        }
+    }
+}
+
+// Moves a finished remesh out of the staging buffers, whose storage is kept for the next one
+void World::swapInStagedMesh(ChunkMesh& mesh) {
+    std::lock_guard<std::mutex> lock(mesh.stagingMutex);
+    if (mesh.isUploaded && mesh.hasNewMesh) {
+        std::swap(mesh.vertices, mesh.stagingVertices);
+        std::swap(mesh.indices, mesh.stagingIndices);
+        std::swap(mesh.faceRecords, mesh.stagingFaceRecords);
+        std::swap(mesh.plantInstances, mesh.stagingPlantInstances);
+        mesh.plantCounts = mesh.stagingPlantCounts;
+        mesh.cellRanges = mesh.stagingCellRanges;
+        mesh.hasCellRanges = true;
+        mesh.lodLevel = mesh.stagingLodLevel;
+        mesh.meshedNeighbors = mesh.stagingMeshedNeighbors;
+        mesh.stagingIndices.clear();
+        mesh.stagingVertices.clear();
+        mesh.stagingFaceRecords.clear();
+        mesh.stagingPlantInstances.clear();
+    }
+    mesh.hasNewMesh = false;
+}
+
 // Uploads the mesh data to the GPU
 void World::uploadMeshToGPU(Chunk& chunk) {
-    if (chunk.mesh.isEmpty) return;
+    ChunkBufferArena& arena = ChunkBufferArena::instance();
+    swapInStagedMesh(chunk.mesh);
+    uploadPlantInstances(chunk.mesh);
 
-    if (chunk.mesh.isUploaded && chunk.mesh.hasNewMesh) {
-        chunk.mesh.VAO.deleteBuffers();
-        chunk.mesh.isUploaded = false;
-        chunk.mesh.vertices = std::move(chunk.mesh.stagingVertices);
-        chunk.mesh.indices  = std::move(chunk.mesh.stagingIndices);
-        chunk.mesh.stagingIndices.clear();
-        chunk.mesh.stagingVertices.clear();
+    if (chunk.mesh.isEmpty || chunk.mesh.vertices.empty()) {
+        arena.release(chunk.mesh.arenaHandle);
+        chunk.mesh.faceRecordBuffer.deleteBuffers();
+        return;
     }
-    
-    if (!chunk.mesh.vertices.empty()) {
-        chunk.mesh.VAO.init();
-        chunk.mesh.VAO.bind();
-        chunk.mesh.VAO.addVertexBuffer(chunk.mesh.vertices);
-        chunk.mesh.VAO.addElementBuffer(chunk.mesh.indices);
-        chunk.mesh.VAO.addAttribute(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
-        chunk.mesh.VAO.addAttribute(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-        chunk.mesh.VAO.addAttribute(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoords));
 
-        chunk.mesh.hasNewMesh = false;
+    // Meshes with face records are drawn by the vertex pulling renderer and never need the vertex buffers,
+    // the others keep the vertex path even while pulling is selected
+    if (!chunk.mesh.faceRecords.empty() && Game::instance().getChunkRenderMode() == ChunkRenderMode::VERTEX_PULLING) {
+        arena.release(chunk.mesh.arenaHandle);
+        chunk.mesh.faceRecordBuffer.upload(chunk.mesh.faceRecords.data(), chunk.mesh.faceRecords.size() * sizeof(uint32_t), GL_R32UI);
+        return;
+    }
+    chunk.mesh.faceRecordBuffer.deleteBuffers();
+
+    // Remeshes that still fit the chunk's ranges are written over the old mesh in place
+    arena.upload(chunk.mesh.arenaHandle, chunk.mesh.vertices, chunk.mesh.indices);
+}
+
+// Plants are drawn from their own buffer in every renderer, chunks without plants hold none
+void World::uploadPlantInstances(ChunkMesh& mesh) {
+    if (mesh.plantInstances.empty()) {
+        mesh.plantInstanceBuffer.deleteBuffers();
+        return;
+    }
+    mesh.plantInstanceBuffer.upload(mesh.plantInstances.data(), mesh.plantInstances.size() * sizeof(uint32_t), GL_R32UI, GL_DYNAMIC_DRAW);
+}
+
+// Patches the chunk's arena ranges from firstVertex onwards with glBufferSubData
+void World::uploadMeshRange(Chunk& chunk, size_t firstVertex, size_t oldIndexCount) {
+    ChunkMesh& mesh = chunk.mesh;
+    ChunkBufferArena& arena = ChunkBufferArena::instance();
+
+    if (mesh.vertices.empty()) {
+        arena.release(mesh.arenaHandle);
+        return;
+    }
+
+    // Meshes that outgrow their ranges move with headroom, so further edits to the same chunk stay in place
+    if (!arena.update(mesh.arenaHandle, mesh.vertices, firstVertex, mesh.indices, oldIndexCount)) {
+        arena.upload(mesh.arenaHandle, mesh.vertices, mesh.indices, 0.25f);
+    }
+}
+
+void World::startUploadThread(GLFWwindow* mainWindow) {
+    uploadThread = std::make_unique<ChunkUploadThread>();
+    if (!uploadThread->start(mainWindow)) {
+        std::cerr << "Could not create a shared context, chunk meshes are uploaded on the main thread" << std::endl;
+        uploadThread.reset();
     }
 }
 
+void World::stopUploadThread() {
+    if (!uploadThread) return;
+    uploadThread->stop();
+    uploadThread.reset();
+}
+
+// Hands a whole vertex buffer mesh to the upload thread, written into new ranges so the old mesh keeps
+// drawing until it is replaced. Empty meshes and face records are left to uploadMeshToGPU
+bool World::queueThreadedUpload(const std::shared_ptr<Chunk>& chunk, bool wasUploaded, int previousLod) {
+    ChunkMesh& mesh = chunk->mesh;
+    swapInStagedMesh(mesh);
+
+    if (mesh.isEmpty || mesh.vertices.empty() || mesh.indices.empty()) return false;
+    if (!mesh.faceRecords.empty() && Game::instance().getChunkRenderMode() == ChunkRenderMode::VERTEX_PULLING) return false;
+
+    ChunkBufferArena& arena = ChunkBufferArena::instance();
+    ArenaHandle handle = INVALID_ARENA_HANDLE;
+    if (!arena.reserve(handle, mesh.vertices.size(), mesh.indices.size())) return false;
+
+    const ArenaAllocation& allocation = arena.get(handle);
+    ChunkUploadThread::Job job;
+    job.chunk = chunk;
+    job.handle = handle;
+    job.vertexBuffer = arena.getVertexBuffer(allocation.page);
+    job.indexBuffer = arena.getIndexBuffer(allocation.page);
+    job.vertexOffset = static_cast<GLintptr>(allocation.firstVertex) * sizeof(Vertex);
+    job.indexOffset = static_cast<GLintptr>(allocation.firstIndex) * sizeof(GLuint);
+    // Copies, the mesh workers and partial remeshes keep using the chunk's own vectors meanwhile
+    job.vertices = mesh.vertices;
+    job.indices = mesh.indices;
+    job.wasUploaded = wasUploaded;
+    job.previousLod = previousLod;
+
+    mesh.pendingArenaHandle = handle;
+    uploadThread->queue(std::move(job));
+    return true;
+}
+
+// Swaps the written ranges in for the chunks' old ones. Chunks unloaded while their upload was
+// in flight no longer point at the ranges, which are freed instead
+void World::collectThreadedUploads() {
+    if (!uploadThread) return;
+
+    ChunkBufferArena& arena = ChunkBufferArena::instance();
+    finishedUploads.clear();
+    uploadThread->collectFinished(finishedUploads);
+
+    for (ChunkUploadThread::Job& job : finishedUploads) {
+        ChunkMesh& mesh = job.chunk->mesh;
+        if (mesh.pendingArenaHandle != job.handle) {
+            arena.release(job.handle);
+            continue;
+        }
+
+        arena.unpin(job.handle);
+        arena.release(mesh.arenaHandle);
+        mesh.faceRecordBuffer.deleteBuffers();
+        // Uploaded with the mesh they belong to, so plants never show up ahead of the ground they stand on
+        uploadPlantInstances(mesh);
+        mesh.arenaHandle = job.handle;
+        mesh.pendingArenaHandle = INVALID_ARENA_HANDLE;
+        finishMeshUpload(job.chunk, job.wasUploaded, job.previousLod);
+    }
+    finishedUploads.clear();
+}
+
 // Uploads the chunk meshes to the map
 void World::uploadChunksToMap() {
     int uploadedChunks = 0;
@@ -423,7 +884,17 @@ void World::uploadChunksToMap() {
         if (chunkUploadQueue.tryPop(chunk)) {
             if (!chunk) continue;
 
-            chunks[chunk->getPosition()] = chunk;
+            // A chunk requested again before the old one at its position was unloaded replaces it. The old mesh's
+            // GPU memory goes with it, and the record is rebuilt from the new chunk, which may have skipped
+            // the upload and have nothing to draw
+            std::shared_ptr<Chunk>& slot = chunks[chunk->getPosition()];
+            if (slot && slot != chunk) {
+                releaseChunkMesh(*slot);
+                renderList.remove(chunk->getPosition());
+                renderList.update(chunk);
+            }
+            slot = chunk;
+            queueMissingNeighborRemeshes(*chunk);
             uploadedChunks++;
         } else {
             return;
@@ -431,17 +902,34 @@ void World::uploadChunksToMap() {
     }
 }
 
+// Frees the GPU side of a chunk leaving the map
+void World::releaseChunkMesh(Chunk& chunk) {
+    ChunkMesh& mesh = chunk.mesh;
+    if (mesh.isUploaded) {
+        try {
+            ChunkBufferArena::instance().release(mesh.arenaHandle);
+            mesh.faceRecordBuffer.deleteBuffers();
+            mesh.plantInstanceBuffer.deleteBuffers();
+        } catch (...) {
+            std::cerr << "Exception in deleteBuffers!" << std::endl;
+        }
+        mesh.vertices.clear();
+        mesh.indices.clear();
+        mesh.faceRecords.clear();
+        mesh.plantInstances.clear();
+    }
+
+    // A mesh still on the upload thread has its ranges freed when it comes back
+    mesh.pendingArenaHandle = INVALID_ARENA_HANDLE;
+}
+
 // Unloads distant chunks based on the player's position and view distance
 void World::queueChunksForRemoval(const glm::ivec3& centerChunk, const int VIEW_DISTANCE) {
-
-    int maxX = centerChunk.x + VIEW_DISTANCE;
-    int maxZ = centerChunk.z + VIEW_DISTANCE;
-    int minX = centerChunk.x - VIEW_DISTANCE;
-    int minZ = centerChunk.z - VIEW_DISTANCE;
+    const float radius = viewRadiusBlocks(VIEW_DISTANCE);
 
     for (auto it = chunkPositionSet.begin(); it != chunkPositionSet.end(); ) {
         const ChunkPosition& pos = *it;
-        if (pos.x > maxX || pos.x < minX || pos.z > maxZ || pos.z < minZ) {
+        if (!isColumnInViewRange(pos.x - centerChunk.x, pos.z - centerChunk.z, radius)) {
             chunkRemovalQueue.push(pos);
             it = chunkPositionSet.erase(it);
         } else {
@@ -457,11 +945,13 @@ void World::unloadDistantChunks() {
         ChunkPosition pos;
         if (!chunkRemovalQueue.tryPop(pos)) break;
 
-        if (std::abs(pos.x - Player::instance().getChunkPosition().x) <= Player::instance().getViewDistance() &&
-            std::abs(pos.z - Player::instance().getChunkPosition().z) <= Player::instance().getViewDistance()) {
+        const glm::ivec3 playerChunk = Player::instance().getChunkPosition();
+        if (isColumnInViewRange(pos.x - playerChunk.x, pos.z - playerChunk.z, viewRadiusBlocks(Player::instance().getViewDistance()))) {
             continue;
         }
 
+        unregisterGeneratedChunk(pos);
+
         auto it = chunks.find(pos);
         if (it == chunks.end()) continue;
 
@@ -472,16 +962,8 @@ void World::unloadDistantChunks() {
             chunkSaveQueue.push(chunkPtr->makeSavableCopy());
         }
 
-        if (chunkPtr->mesh.isUploaded) {
-            try {
-                chunkPtr->mesh.VAO.deleteBuffers();
-            } catch (...) {
-                std::cerr << "Exception in deleteBuffers!" << std::endl;
-            }
-            chunkPtr->mesh.vertices.clear();
-            chunkPtr->mesh.indices.clear();
-        }
-
+        releaseChunkMesh(*chunkPtr);
+        renderList.remove(pos);
         chunks.erase(it);
     }
 }
@@ -544,6 +1026,15 @@ bool World::wouldBlockOverlapPlayer(const glm::ivec3& blockPos) const {
     );
 }
 
+// Moves the cloud ring with the camera and uploads the tiles the worker has finished
+void World::updateCloudsAroundPlayer() {
+    clouds.update(Player::instance().getCamera().position, static_cast<float>(glfwGetTime()));
+}
+
+void World::drawClouds(Shader& cloudShader) {
+    clouds.draw(cloudShader);
+}
+
 // Saves the chunk to a file
 void World::saveChunkToFile(const std::shared_ptr<Chunk>& chunk) {
     const ChunkPosition& pos = chunk->getPosition();
@@ -574,6 +1065,20 @@ void World::saveChunkToFile(const std::shared_ptr<Chunk>& chunk) {
     buffer.insert(buffer.end(), reinterpret_cast<const char*>(&indexCount), reinterpret_cast<const char*>(&indexCount) + sizeof(uint32_t));
     buffer.insert(buffer.end(), reinterpret_cast<const char*>(indices.data()), reinterpret_cast<const char*>(indices.data()) + indexCount * sizeof(GLuint));
 
+    // Chunk mesh slot layout, appended last so files without it still load
+    uint32_t rangeCount = chunk->mesh.hasCellRanges ? static_cast<uint32_t>(chunk->mesh.cellRanges.size()) : 0;
+    buffer.insert(buffer.end(), reinterpret_cast<const char*>(&rangeCount), reinterpret_cast<const char*>(&rangeCount) + sizeof(uint32_t));
+    buffer.insert(buffer.end(), reinterpret_cast<const char*>(chunk->mesh.cellRanges.data()), reinterpret_cast<const char*>(chunk->mesh.cellRanges.data()) + rangeCount * sizeof(uint32_t));
+
+    uint32_t lodLevel = chunk->mesh.lodLevel;
+    buffer.insert(buffer.end(), reinterpret_cast<const char*>(&lodLevel), reinterpret_cast<const char*>(&lodLevel) + sizeof(uint32_t));
+
+    uint8_t meshedNeighbors = chunk->mesh.meshedNeighbors;
+    buffer.insert(buffer.end(), reinterpret_cast<const char*>(&meshedNeighbors), reinterpret_cast<const char*>(&meshedNeighbors) + sizeof(uint8_t));
+
+    uint8_t plantsInstanced = chunk->mesh.plantsInstanced ? 1 : 0;
+    buffer.insert(buffer.end(), reinterpret_cast<const char*>(&plantsInstanced), reinterpret_cast<const char*>(&plantsInstanced) + sizeof(uint8_t));
+
     size_t maxSize = ZSTD_compressBound(buffer.size());
     std::vector<char> compressedBuffer(maxSize);
     size_t compressedSize = ZSTD_compress(compressedBuffer.data(), maxSize, buffer.data(), buffer.size(), 1);
@@ -651,7 +1156,31 @@ bool World::loadChunkFromFile(const ChunkPosition& pos, std::shared_ptr<Chunk>&
     chunkOut->mesh.indices.resize(indexCount);
     read(chunkOut->mesh.indices.data(), indexCount * sizeof(GLuint));
 
-    chunkOut->mesh.isEmpty = chunkOut->mesh.vertices.empty() && chunkOut->mesh.indices.empty();
+    uint32_t rangeCount = 0;
+    if (offset + sizeof(uint32_t) <= buffer.size()) read(&rangeCount, sizeof(uint32_t));
+    if (rangeCount == chunkOut->mesh.cellRanges.size() && offset + rangeCount * sizeof(uint32_t) <= buffer.size()) {
+        read(chunkOut->mesh.cellRanges.data(), rangeCount * sizeof(uint32_t));
+        chunkOut->mesh.hasCellRanges = chunkOut->mesh.cellRanges[MESH_SLOT_COUNT] * 4 == vertCount;
+    }
+
+    uint32_t lodLevel = 0;
+    if (offset + sizeof(uint32_t) <= buffer.size()) read(&lodLevel, sizeof(uint32_t));
+    chunkOut->mesh.lodLevel = lodLevel <= MAX_MESH_LOD ? static_cast<int>(lodLevel) : 0;
+
+    uint8_t meshedNeighbors = 0;
+    if (offset + sizeof(uint8_t) <= buffer.size()) read(&meshedNeighbors, sizeof(uint8_t));
+    chunkOut->mesh.meshedNeighbors = meshedNeighbors & ALL_NEIGHBORS;
+
+    uint8_t plantsInstanced = 0;
+    if (offset + sizeof(uint8_t) <= buffer.size()) read(&plantsInstanced, sizeof(uint8_t));
+    chunkOut->mesh.plantsInstanced = plantsInstanced != 0;
+
+    // Plants are rebuilt from the blocks, only when the saved vertices were meshed without them
+    if (chunkOut->mesh.plantsInstanced && chunkOut->mesh.lodLevel == 0) {
+        chunkOut->generatePlantInstances(chunkOut->mesh.plantInstances, chunkOut->mesh.plantCounts);
+    }
+
+    chunkOut->mesh.isEmpty = chunkOut->mesh.vertices.empty() && chunkOut->mesh.indices.empty() && chunkOut->mesh.plantInstances.empty();
     chunkOut->mesh.needsUpdate = false;
     chunkOut->mesh.isUploaded = false;
     
@@ -871,6 +1400,14 @@ void World::serializeChunk(SavableChunk& chunk, std::vector<uint8_t>& out) {
     out.insert(out.end(),
         reinterpret_cast<const uint8_t*>(indices.data()),
         reinterpret_cast<const uint8_t*>(indices.data()) + indices.size() * sizeof(GLuint));
+
+    // Mesh slot layout, trailing so readers that predate it ignore it
+    const auto& ranges = chunk.cellRanges;
+    int32_t rangeCount = chunk.hasCellRanges ? static_cast<int32_t>(ranges.size()) : 0;
+    Serializer::writeInt32(out, rangeCount);
+    out.insert(out.end(),
+        reinterpret_cast<const uint8_t*>(ranges.data()),
+        reinterpret_cast<const uint8_t*>(ranges.data()) + rangeCount * sizeof(uint32_t));
 }
 
 std::shared_ptr<Chunk> World::deserializeChunk(const std::vector<uint8_t>& in) {
@@ -903,6 +1440,16 @@ std::shared_ptr<Chunk> World::deserializeChunk(const std::vector<uint8_t>& in) {
     std::memcpy(chunk->mesh.indices.data(), in.data() + offset, indexCount * sizeof(GLuint));
     offset += indexCount * sizeof(GLuint);
 
+    // Mesh slot layout, missing from older peers
+    if (offset + sizeof(int32_t) <= in.size()) {
+        int rangeCount = Serializer::readInt32(in, offset);
+        if (rangeCount == static_cast<int>(chunk->mesh.cellRanges.size()) && offset + rangeCount * sizeof(uint32_t) <= in.size()) {
+            std::memcpy(chunk->mesh.cellRanges.data(), in.data() + offset, rangeCount * sizeof(uint32_t));
+            offset += rangeCount * sizeof(uint32_t);
+            chunk->mesh.hasCellRanges = chunk->mesh.cellRanges[MESH_SLOT_COUNT] * 4 == static_cast<uint32_t>(vertCount);
+        }
+    }
+
     chunk->mesh.isEmpty = chunk->mesh.vertices.empty() && chunk->mesh.indices.empty();
     chunk->mesh.needsUpdate = false;
     chunk->mesh.isUploaded = false;
@@ -953,11 +1500,13 @@ void World::networkWorker(ChunkPosition pos) {
         Message response = Message::deserialize(payload);
         if (response.type == MessageType::ChunkData) {
             auto chunk = World::instance().deserializeChunk(response.data);
+            registerGeneratedChunk(chunk);
             meshUploadQueue.push(chunk);
         } else if (response.type == MessageType::ChunkNotFound) {
             auto chunk = std::make_shared<Chunk>();
             chunk->setPosition(pos);
             chunk->generateTerrain();
+            registerGeneratedChunk(chunk);
             meshGenerationQueue.push(chunk);
 
             Message generated;
@@ -1050,6 +1599,7 @@ bool World::requestChunkOverUDP(const ChunkPosition& pos, std::shared_ptr<Chunk>
             }
             
             std::shared_ptr<Chunk> chunk = deserializeChunk(decompressed);
+            registerGeneratedChunk(chunk);
             meshUploadQueue.push(chunk);
         }
 
@@ -1240,6 +1790,7 @@ void World::pollTCPMessages() {
 
             std::shared_ptr<Chunk> chunk = deserializeChunk(decompressed);
             std::cout << "[Client] Received chunk update for " << pos.x << ", " << pos.y << ", " << pos.z << "\n";
+            registerGeneratedChunk(chunk);
             meshUploadQueue.push(chunk);
         }
 
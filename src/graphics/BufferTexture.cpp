@@ -0,0 +1,44 @@
+#include "graphics/BufferTexture.h"
+
+BufferTexture::BufferTexture() {
+    this->buffer = 0;
+    this->texture = 0;
+}
+
+BufferTexture::~BufferTexture() {}
+
+void BufferTexture::upload(const void* data, size_t bytes, GLenum internalFormat, GLenum usage) {
+    if (texture == 0) {
+        glGenBuffers(1, &buffer);
+        glGenTextures(1, &texture);
+    }
+
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+    if (bytes > capacity || capacity == 0) {
+        glBufferData(GL_TEXTURE_BUFFER, bytes, data, usage);
+        capacity = bytes;
+    } else {
+        glBufferSubData(GL_TEXTURE_BUFFER, 0, bytes, data);
+    }
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    size = bytes;
+
+    // The texture keeps referencing the buffer object, but has to be reattached after it was respecified
+    glBindTexture(GL_TEXTURE_BUFFER, texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, internalFormat, buffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+}
+
+void BufferTexture::bind(GLuint unit) const {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_BUFFER, texture);
+}
+
+void BufferTexture::deleteBuffers() {
+    if (texture == 0) return;
+    glDeleteTextures(1, &texture);
+    glDeleteBuffers(1, &buffer);
+    buffer = texture = 0;
+    size = 0;
+    capacity = 0;
+}
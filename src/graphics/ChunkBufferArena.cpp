@@ -0,0 +1,475 @@
+#include "graphics/ChunkBufferArena.h"
+
+#include <iostream>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+RangeAllocator::RangeAllocator(uint32_t capacity) : capacity(capacity), freeUnits(capacity) {
+    if (capacity > 0) freeRanges[0] = capacity;
+}
+
+uint32_t RangeAllocator::allocate(uint32_t size) {
+    return allocateBelow(size, capacity);
+}
+
+uint32_t RangeAllocator::allocateBelow(uint32_t size, uint32_t limit) {
+    if (size == 0) return INVALID_OFFSET;
+
+    for (auto it = freeRanges.begin(); it != freeRanges.end() && it->first < limit; ++it) {
+        const uint32_t offset = it->first;
+        const uint32_t rangeSize = it->second;
+        if (rangeSize < size || offset + size > limit) continue;
+
+        freeRanges.erase(it);
+        if (rangeSize > size) freeRanges[offset + size] = rangeSize - size;
+        freeUnits -= size;
+        return offset;
+    }
+    return INVALID_OFFSET;
+}
+
+void RangeAllocator::release(uint32_t offset, uint32_t size) {
+    if (size == 0) return;
+    freeUnits += size;
+
+    auto next = freeRanges.lower_bound(offset);
+    if (next != freeRanges.end() && offset + size == next->first) {
+        size += next->second;
+        next = freeRanges.erase(next);
+    }
+    if (next != freeRanges.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == offset) {
+            prev->second += size;
+            return;
+        }
+    }
+    freeRanges[offset] = size;
+}
+
+uint32_t RangeAllocator::getLargestFreeRange() const {
+    uint32_t largest = 0;
+    for (const auto& [offset, size] : freeRanges) largest = std::max(largest, size);
+    return largest;
+}
+
+ChunkBufferArena* ChunkBufferArena::s_instance = nullptr;
+
+void ChunkBufferArena::setInstance(ChunkBufferArena* instance) {
+    s_instance = instance;
+}
+
+ChunkBufferArena& ChunkBufferArena::instance() {
+    if (!s_instance) {
+        std::cerr << "ChunkBufferArena::instance() called before ChunkBufferArena::setInstance()!\n";
+        std::exit(1);
+    }
+    return *s_instance;
+}
+
+ChunkBufferArena::ChunkBufferArena(uint32_t pageVertices, uint32_t pageIndices)
+    : pageVertices(pageVertices), pageIndices(pageIndices) {
+    // The context is requested as 3.3 core, but drivers usually hand out their newest core version
+#ifdef GL_VERSION_4_3
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    indirectDraws = GLAD_GL_VERSION_4_3 && (major > 4 || (major == 4 && minor >= 3));
+#endif
+}
+
+ChunkBufferArena::~ChunkBufferArena() {}
+
+// Creates one page, reusing the slot of a destroyed page so page numbers of live allocations stay put
+int ChunkBufferArena::createPage() {
+    int index = -1;
+    for (size_t i = 0; i < pages.size(); ++i) {
+        if (pages[i].VAO == 0) {
+            index = static_cast<int>(i);
+            break;
+        }
+    }
+    if (index < 0) {
+        index = static_cast<int>(pages.size());
+        pages.emplace_back();
+    }
+
+    Page& page = pages[index];
+    page.vertices = RangeAllocator(pageVertices);
+    page.indices = RangeAllocator(pageIndices);
+    page.liveAllocations = 0;
+
+    glGenVertexArrays(1, &page.VAO);
+    glGenBuffers(1, &page.VBO);
+    glGenBuffers(1, &page.EBO);
+
+    glBindVertexArray(page.VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, page.VBO);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(pageVertices) * sizeof(Vertex), nullptr, GL_DYNAMIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoords));
+    glEnableVertexAttribArray(2);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, page.EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(pageIndices) * sizeof(GLuint), nullptr, GL_DYNAMIC_DRAW);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    boundPage = -1;
+
+    // The upload thread's context writes into these buffers, their storage has to reach the server
+    // before any of those writes are issued
+    glFlush();
+
+    return index;
+}
+
+void ChunkBufferArena::destroyPage(int index) {
+    Page& page = pages[index];
+    glDeleteVertexArrays(1, &page.VAO);
+    glDeleteBuffers(1, &page.VBO);
+    glDeleteBuffers(1, &page.EBO);
+    page = Page();
+    if (boundPage == index) boundPage = -1;
+}
+
+bool ChunkBufferArena::allocateRanges(ArenaAllocation& allocation, uint32_t vertexCapacity, uint32_t indexCapacity) {
+    if (vertexCapacity > pageVertices || indexCapacity > pageIndices) {
+        std::cerr << "Chunk mesh does not fit in an arena page: " << vertexCapacity << " vertices, " << indexCapacity << " indices" << std::endl;
+        return false;
+    }
+
+    auto tryPage = [&](int index) {
+        Page& page = pages[index];
+        if (page.VAO == 0) return false;
+
+        uint32_t firstVertex = page.vertices.allocate(vertexCapacity);
+        if (firstVertex == RangeAllocator::INVALID_OFFSET) return false;
+        uint32_t firstIndex = page.indices.allocate(indexCapacity);
+        if (firstIndex == RangeAllocator::INVALID_OFFSET) {
+            page.vertices.release(firstVertex, vertexCapacity);
+            return false;
+        }
+
+        allocation.page = index;
+        allocation.firstVertex = firstVertex;
+        allocation.vertexCapacity = vertexCapacity;
+        allocation.firstIndex = firstIndex;
+        allocation.indexCapacity = indexCapacity;
+        ++page.liveAllocations;
+        layoutChanged = true;
+        return true;
+    };
+
+    for (size_t i = 0; i < pages.size(); ++i) {
+        if (tryPage(static_cast<int>(i))) return true;
+    }
+    return tryPage(createPage());
+}
+
+void ChunkBufferArena::releaseRanges(ArenaAllocation& allocation) {
+    if (allocation.page < 0 || pages[allocation.page].VAO == 0) {
+        allocation = ArenaAllocation();
+        return;
+    }
+
+    Page& page = pages[allocation.page];
+    page.vertices.release(allocation.firstVertex, allocation.vertexCapacity);
+    page.indices.release(allocation.firstIndex, allocation.indexCapacity);
+    --page.liveAllocations;
+    layoutChanged = true;
+    allocation = ArenaAllocation();
+}
+
+// Writes go through the copy targets so the element buffer binding of whatever VAO is bound stays untouched
+void ChunkBufferArena::writeVertices(const ArenaAllocation& allocation, const Vertex* data, size_t first, size_t count) {
+    if (count == 0) return;
+    glBindBuffer(GL_COPY_WRITE_BUFFER, pages[allocation.page].VBO);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, (allocation.firstVertex + first) * sizeof(Vertex), count * sizeof(Vertex), data + first);
+}
+
+void ChunkBufferArena::writeIndices(const ArenaAllocation& allocation, const GLuint* data, size_t first, size_t count) {
+    if (count == 0) return;
+    glBindBuffer(GL_COPY_WRITE_BUFFER, pages[allocation.page].EBO);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, (allocation.firstIndex + first) * sizeof(GLuint), count * sizeof(GLuint), data + first);
+}
+
+bool ChunkBufferArena::upload(ArenaHandle& handle, const std::vector<Vertex>& vertices, const std::vector<GLuint>& indices, float headroom) {
+    if (vertices.empty() || indices.empty()) {
+        release(handle);
+        return false;
+    }
+
+    if (!isValid(handle)) {
+        if (freeHandles.empty()) {
+            handle = static_cast<ArenaHandle>(allocations.size());
+            allocations.emplace_back();
+        } else {
+            handle = freeHandles.back();
+            freeHandles.pop_back();
+        }
+    }
+
+    ArenaAllocation& allocation = allocations[handle];
+    if (allocation.page < 0 || vertices.size() > allocation.vertexCapacity || indices.size() > allocation.indexCapacity) {
+        releaseRanges(allocation);
+
+        uint32_t vertexCapacity = static_cast<uint32_t>(vertices.size() + vertices.size() * headroom);
+        uint32_t indexCapacity = static_cast<uint32_t>(indices.size() + indices.size() * headroom);
+        if (!allocateRanges(allocation, vertexCapacity, indexCapacity)) {
+            freeHandles.push_back(handle);
+            handle = INVALID_ARENA_HANDLE;
+            return false;
+        }
+    }
+
+    allocation.vertexCount = static_cast<uint32_t>(vertices.size());
+    allocation.indexCount = static_cast<uint32_t>(indices.size());
+    writeVertices(allocation, vertices.data(), 0, vertices.size());
+    writeIndices(allocation, indices.data(), 0, indices.size());
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    return true;
+}
+
+bool ChunkBufferArena::update(ArenaHandle handle, const std::vector<Vertex>& vertices, size_t firstVertex, const std::vector<GLuint>& indices, size_t firstIndex) {
+    if (!isValid(handle)) return false;
+
+    ArenaAllocation& allocation = allocations[handle];
+    if (vertices.size() > allocation.vertexCapacity || indices.size() > allocation.indexCapacity) return false;
+
+    allocation.vertexCount = static_cast<uint32_t>(vertices.size());
+    allocation.indexCount = static_cast<uint32_t>(indices.size());
+    if (firstVertex < vertices.size()) writeVertices(allocation, vertices.data(), firstVertex, vertices.size() - firstVertex);
+    if (firstIndex < indices.size()) writeIndices(allocation, indices.data(), firstIndex, indices.size() - firstIndex);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    return true;
+}
+
+void ChunkBufferArena::release(ArenaHandle& handle) {
+    if (!isValid(handle)) {
+        handle = INVALID_ARENA_HANDLE;
+        return;
+    }
+
+    releaseRanges(allocations[handle]);
+    freeHandles.push_back(handle);
+    handle = INVALID_ARENA_HANDLE;
+}
+
+bool ChunkBufferArena::reserve(ArenaHandle& handle, size_t vertexCount, size_t indexCount) {
+    if (vertexCount == 0 || indexCount == 0) return false;
+
+    if (freeHandles.empty()) {
+        handle = static_cast<ArenaHandle>(allocations.size());
+        allocations.emplace_back();
+    } else {
+        handle = freeHandles.back();
+        freeHandles.pop_back();
+    }
+
+    ArenaAllocation& allocation = allocations[handle];
+    if (!allocateRanges(allocation, static_cast<uint32_t>(vertexCount), static_cast<uint32_t>(indexCount))) {
+        freeHandles.push_back(handle);
+        handle = INVALID_ARENA_HANDLE;
+        return false;
+    }
+
+    allocation.vertexCount = static_cast<uint32_t>(vertexCount);
+    allocation.indexCount = static_cast<uint32_t>(indexCount);
+    allocation.pinned = true;
+    return true;
+}
+
+void ChunkBufferArena::unpin(ArenaHandle handle) {
+    if (!isValid(handle)) return;
+    allocations[handle].pinned = false;
+    layoutChanged = true;
+}
+
+size_t ChunkBufferArena::getAllocationBytes(ArenaHandle handle) const {
+    if (!isValid(handle)) return 0;
+    const ArenaAllocation& allocation = allocations[handle];
+    return static_cast<size_t>(allocation.vertexCapacity) * sizeof(Vertex) + static_cast<size_t>(allocation.indexCapacity) * sizeof(GLuint);
+}
+
+void ChunkBufferArena::bindPage(int page) {
+    if (page == boundPage) return;
+    glBindVertexArray(pages[page].VAO);
+    boundPage = page;
+}
+
+void ChunkBufferArena::unbind() {
+    glBindVertexArray(0);
+    boundPage = -1;
+}
+
+void ChunkBufferArena::beginBatch() {
+    batches.resize(pages.size());
+    for (auto& batch : batches) batch.clear();
+}
+
+void ChunkBufferArena::addDraw(ArenaHandle handle, size_t firstIndex, size_t indexCount) {
+    if (!isValid(handle) || indexCount == 0) return;
+
+    const ArenaAllocation& allocation = allocations[handle];
+    batches[allocation.page].push_back({ static_cast<GLuint>(indexCount), 1,
+                                         static_cast<GLuint>(allocation.firstIndex + firstIndex),
+                                         static_cast<GLint>(allocation.firstVertex), 0 });
+}
+
+int ChunkBufferArena::drawBatch() {
+    int drawCalls = 0;
+
+#ifdef GL_VERSION_4_3
+    if (indirectDraws) {
+        // Every page's commands go into one buffer, each page draws its slice of it
+        indirectCommands.clear();
+        for (const auto& batch : batches) indirectCommands.insert(indirectCommands.end(), batch.begin(), batch.end());
+        if (indirectCommands.empty()) return 0;
+
+        if (indirectBuffer == 0) glGenBuffers(1, &indirectBuffer);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+        const size_t bytes = indirectCommands.size() * sizeof(DrawElementsIndirectCommand);
+        if (bytes > indirectBufferCapacity) indirectBufferCapacity = std::max(bytes, indirectBufferCapacity * 2);
+        // Orphaned every frame so the driver does not wait for last frame's draws to finish reading it
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, indirectBufferCapacity, nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, bytes, indirectCommands.data());
+
+        size_t offset = 0;
+        for (size_t page = 0; page < batches.size(); ++page) {
+            if (batches[page].empty()) continue;
+            bindPage(static_cast<int>(page));
+            glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+                                        (void*)(offset * sizeof(DrawElementsIndirectCommand)),
+                                        static_cast<GLsizei>(batches[page].size()), 0);
+            offset += batches[page].size();
+            ++drawCalls;
+        }
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        return drawCalls;
+    }
+#endif
+
+    for (size_t page = 0; page < batches.size(); ++page) {
+        const auto& batch = batches[page];
+        if (batch.empty()) continue;
+
+        batchCounts.clear();
+        batchOffsets.clear();
+        batchBaseVertices.clear();
+        for (const DrawElementsIndirectCommand& command : batch) {
+            batchCounts.push_back(static_cast<GLsizei>(command.count));
+            batchOffsets.push_back((const void*)(command.firstIndex * sizeof(GLuint)));
+            batchBaseVertices.push_back(command.baseVertex);
+        }
+
+        bindPage(static_cast<int>(page));
+        glMultiDrawElementsBaseVertex(GL_TRIANGLES, batchCounts.data(), GL_UNSIGNED_INT, batchOffsets.data(),
+                                      static_cast<GLsizei>(batch.size()), batchBaseVertices.data());
+        ++drawCalls;
+    }
+    return drawCalls;
+}
+
+void ChunkBufferArena::defragment(int maxMoves) {
+    // The first page is kept so the common case of one page never recreates its buffers
+    for (size_t i = 1; i < pages.size(); ++i) {
+        if (pages[i].VAO != 0 && pages[i].liveAllocations == 0) destroyPage(static_cast<int>(i));
+    }
+
+    // Nothing can move until a range is allocated, freed or unpinned after a pass that found no moves
+    if (!layoutChanged) return;
+    if (getStats().fragmentation < 0.25f) {
+        layoutChanged = false;
+        return;
+    }
+
+    // Highest ranges move first, so free space collects at the end of each page
+    std::vector<std::pair<uint32_t, ArenaHandle>> order;
+    order.reserve(allocations.size());
+    for (ArenaHandle handle = 0; handle < allocations.size(); ++handle) {
+        if (allocations[handle].page >= 0 && !allocations[handle].pinned) order.emplace_back(allocations[handle].firstVertex, handle);
+    }
+    std::sort(order.begin(), order.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    int moves = 0;
+    for (const auto& [offset, handle] : order) {
+        if (moves >= maxMoves) break;
+
+        ArenaAllocation& allocation = allocations[handle];
+        Page& page = pages[allocation.page];
+
+        // Targets end before the range they replace, so source and destination never overlap
+        uint32_t firstVertex = page.vertices.allocateBelow(allocation.vertexCapacity, allocation.firstVertex);
+        if (firstVertex != RangeAllocator::INVALID_OFFSET) {
+            glBindBuffer(GL_COPY_READ_BUFFER, page.VBO);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, page.VBO);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, allocation.firstVertex * sizeof(Vertex),
+                                firstVertex * sizeof(Vertex), allocation.vertexCount * sizeof(Vertex));
+            page.vertices.release(allocation.firstVertex, allocation.vertexCapacity);
+            allocation.firstVertex = firstVertex;
+            ++moves;
+        }
+
+        uint32_t firstIndex = page.indices.allocateBelow(allocation.indexCapacity, allocation.firstIndex);
+        if (firstIndex != RangeAllocator::INVALID_OFFSET) {
+            glBindBuffer(GL_COPY_READ_BUFFER, page.EBO);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, page.EBO);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, allocation.firstIndex * sizeof(GLuint),
+                                firstIndex * sizeof(GLuint), allocation.indexCount * sizeof(GLuint));
+            page.indices.release(allocation.firstIndex, allocation.indexCapacity);
+            allocation.firstIndex = firstIndex;
+            ++moves;
+        }
+    }
+
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    if (moves == 0) layoutChanged = false;
+}
+
+ChunkBufferArena::Stats ChunkBufferArena::getStats() const {
+    Stats stats;
+    stats.allocations = allocations.size() - freeHandles.size();
+
+    size_t largestFreeBytes = 0;
+    for (const Page& page : pages) {
+        if (page.VAO == 0) continue;
+        ++stats.pages;
+
+        stats.capacityBytes += static_cast<size_t>(page.vertices.getCapacity()) * sizeof(Vertex)
+                             + static_cast<size_t>(page.indices.getCapacity()) * sizeof(GLuint);
+        stats.freeBytes += static_cast<size_t>(page.vertices.getFreeUnits()) * sizeof(Vertex)
+                         + static_cast<size_t>(page.indices.getFreeUnits()) * sizeof(GLuint);
+        largestFreeBytes += static_cast<size_t>(page.vertices.getLargestFreeRange()) * sizeof(Vertex)
+                          + static_cast<size_t>(page.indices.getLargestFreeRange()) * sizeof(GLuint);
+    }
+
+    stats.usedBytes = stats.capacityBytes - stats.freeBytes;
+    stats.fragmentation = stats.freeBytes > 0 ? 1.0f - static_cast<float>(largestFreeBytes) / stats.freeBytes : 0.0f;
+    return stats;
+}
+
+std::string ChunkBufferArena::summary() const {
+    Stats stats = getStats();
+    char buffer[128];
+    std::snprintf(buffer, sizeof(buffer), "arena %.1f/%.1f MB, %zu pages, %.0f%% frag",
+                  stats.usedBytes / (1024.0 * 1024.0), stats.capacityBytes / (1024.0 * 1024.0),
+                  stats.pages, stats.fragmentation * 100.0f);
+    return buffer;
+}
+
+void ChunkBufferArena::deleteBuffers() {
+    for (size_t i = 0; i < pages.size(); ++i) {
+        if (pages[i].VAO != 0) destroyPage(static_cast<int>(i));
+    }
+    boundPage = -1;
+
+    if (indirectBuffer != 0) glDeleteBuffers(1, &indirectBuffer);
+    indirectBuffer = 0;
+    indirectBufferCapacity = 0;
+}
@@ -0,0 +1,168 @@
+#include "graphics/FrameProfiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+FrameProfiler::Scope::Scope(FrameProfiler& profiler, const char* name, bool gpu)
+    : profiler(profiler), section(profiler.beginSection(name, gpu)) {}
+
+FrameProfiler::Scope::~Scope() {
+    profiler.endSection(section);
+}
+
+bool FrameProfiler::openLog(const std::string& path) {
+    log.open(path, std::ios::trunc);
+    if (!log) return false;
+    log << "frame,section,cpu_ms,gpu_ms\n";
+    return true;
+}
+
+void FrameProfiler::beginFrame() {
+    if (!enabled) return;
+    ++frame;
+}
+
+void FrameProfiler::endFrame() {
+    if (!enabled || !log) return;
+    // Rows are only pushed out once per second of frames, the file is written in large blocks
+    if (frame % 60 == 0) log.flush();
+}
+
+// Sections are found by name, the names are string literals so the pointer comparison nearly always hits
+int FrameProfiler::beginSection(const char* name, bool gpu) {
+    if (!enabled) return -1;
+
+    int index = -1;
+    for (size_t i = 0; i < sections.size(); ++i) {
+        if (sections[i].name == name || std::strcmp(sections[i].name, name) == 0) {
+            index = static_cast<int>(i);
+            break;
+        }
+    }
+    if (index < 0) {
+        if (sections.size() >= MAX_SECTIONS) return -1;
+        index = static_cast<int>(sections.size());
+        sections.emplace_back();
+        sections.back().name = name;
+        sections.back().gpu = gpu;
+    }
+
+    Section& section = sections[index];
+    section.start = std::chrono::steady_clock::now();
+
+    if (section.gpu) {
+        // The query this frame reuses is read first. If the GPU is still busy with it the frame goes untimed
+        const int buffer = static_cast<int>(frame % QUERY_BUFFERS);
+        readQuery(section, buffer);
+        if (!section.pending[buffer]) {
+            if (section.queries[buffer] == 0) glGenQueries(1, &section.queries[buffer]);
+            glBeginQuery(GL_TIME_ELAPSED, section.queries[buffer]);
+            section.pending[buffer] = true;
+            section.queryFrames[buffer] = frame;
+        }
+    }
+    return index;
+}
+
+void FrameProfiler::endSection(int index) {
+    if (!enabled || index < 0) return;
+
+    Section& section = sections[index];
+    const float cpuMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - section.start).count();
+    pushSample(section.cpuHistory, section.cpuSamples, cpuMilliseconds);
+
+    const int buffer = static_cast<int>(frame % QUERY_BUFFERS);
+    if (section.gpu && section.pending[buffer] && section.queryFrames[buffer] == frame) {
+        glEndQuery(GL_TIME_ELAPSED);
+        section.queryCpuMilliseconds[buffer] = cpuMilliseconds;
+    } else if (log) {
+        log << frame << ',' << section.name << ',' << cpuMilliseconds << ",\n";
+    }
+}
+
+void FrameProfiler::readQuery(Section& section, int buffer) {
+    if (!section.pending[buffer]) return;
+
+    GLuint available = 0;
+    glGetQueryObjectuiv(section.queries[buffer], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) return;
+
+    GLuint64 nanoseconds = 0;
+    glGetQueryObjectui64v(section.queries[buffer], GL_QUERY_RESULT, &nanoseconds);
+    section.pending[buffer] = false;
+
+    const float gpuMilliseconds = static_cast<float>(nanoseconds / 1e6);
+    pushSample(section.gpuHistory, section.gpuSamples, gpuMilliseconds);
+    if (log) {
+        log << section.queryFrames[buffer] << ',' << section.name << ',' << section.queryCpuMilliseconds[buffer] << ',' << gpuMilliseconds << '\n';
+    }
+}
+
+void FrameProfiler::pushSample(std::array<float, HISTORY>& history, int& samples, float value) {
+    history[samples % HISTORY] = value;
+    ++samples;
+    // Wraps back into the second lap so the count never overflows but still reads as a full history
+    if (samples >= 2 * HISTORY) samples -= HISTORY;
+}
+
+void FrameProfiler::stats(const std::array<float, HISTORY>& history, int samples, float& average, float& p95) {
+    const int count = std::min(samples, HISTORY);
+    average = 0.0f;
+    p95 = 0.0f;
+    if (count == 0) return;
+
+    std::array<float, HISTORY> sorted;
+    std::copy(history.begin(), history.begin() + count, sorted.begin());
+    for (int i = 0; i < count; ++i) average += sorted[i];
+    average /= count;
+
+    auto nth = sorted.begin() + (count - 1) * 95 / 100;
+    std::nth_element(sorted.begin(), nth, sorted.begin() + count);
+    p95 = *nth;
+}
+
+std::string FrameProfiler::summary() const {
+    if (!enabled) return "";
+
+    std::string result;
+    char buffer[128];
+    for (const Section& section : sections) {
+        float cpuAverage, cpuP95, gpuAverage, gpuP95;
+        stats(section.cpuHistory, section.cpuSamples, cpuAverage, cpuP95);
+        if (section.gpu) {
+            stats(section.gpuHistory, section.gpuSamples, gpuAverage, gpuP95);
+            std::snprintf(buffer, sizeof(buffer), "%s%s %.2f/%.2f cpu %.2f/%.2f gpu", result.empty() ? "" : ", ",
+                          section.name, cpuAverage, cpuP95, gpuAverage, gpuP95);
+        } else {
+            std::snprintf(buffer, sizeof(buffer), "%s%s %.2f/%.2f cpu", result.empty() ? "" : ", ",
+                          section.name, cpuAverage, cpuP95);
+        }
+        result += buffer;
+    }
+    return result.empty() ? result : result + " ms (avg/p95)";
+}
+
+float FrameProfiler::recentGpuMilliseconds(int frames) const {
+    float total = 0.0f;
+    for (const Section& section : sections) {
+        const int count = std::min({ frames, section.gpuSamples, HISTORY });
+        if (!section.gpu || count == 0) continue;
+
+        float sum = 0.0f;
+        for (int i = 1; i <= count; ++i) sum += section.gpuHistory[(section.gpuSamples - i) % HISTORY];
+        total += sum / count;
+    }
+    return total;
+}
+
+void FrameProfiler::deleteQueries() {
+    for (Section& section : sections) {
+        for (GLuint& query : section.queries) {
+            if (query != 0) glDeleteQueries(1, &query);
+            query = 0;
+        }
+        section.pending = {};
+    }
+    if (log) log.flush();
+}
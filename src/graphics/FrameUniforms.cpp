@@ -0,0 +1,28 @@
+#include "graphics/FrameUniforms.h"
+
+static_assert(sizeof(FrameUniformData) == 160, "FrameUniformData has to match the std140 FrameUniforms block");
+
+FrameUniformBuffer::FrameUniformBuffer() {}
+
+FrameUniformBuffer::~FrameUniformBuffer() {}
+
+void FrameUniformBuffer::init() {
+    glGenBuffers(1, &UBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniformData), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, BINDING, UBO);
+}
+
+// Orphans the old contents so the driver does not wait for last frame's draws
+void FrameUniformBuffer::update(const FrameUniformData& data) {
+    glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniformData), nullptr, GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameUniformData), &data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void FrameUniformBuffer::deleteBuffers() {
+    if (UBO != 0) glDeleteBuffers(1, &UBO);
+    UBO = 0;
+}
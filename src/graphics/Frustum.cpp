@@ -0,0 +1,84 @@
+#include "graphics/Frustum.h"
+
+#include <algorithm>
+#include <cmath>
+
+void AABBArray::push(const glm::vec3& min, const glm::vec3& max) {
+    glm::vec3 center = (min + max) * 0.5f;
+    glm::vec3 extent = (max - min) * 0.5f;
+    centerX.push_back(center.x);
+    centerY.push_back(center.y);
+    centerZ.push_back(center.z);
+    extentX.push_back(extent.x);
+    extentY.push_back(extent.y);
+    extentZ.push_back(extent.z);
+}
+
+void AABBArray::clear() {
+    centerX.clear();
+    centerY.clear();
+    centerZ.clear();
+    extentX.clear();
+    extentY.clear();
+    extentZ.clear();
+}
+
+// Gribb and Hartmann: each plane is the fourth row of the matrix plus or minus one of the others
+void Frustum::update(const glm::mat4& viewProjection) {
+    glm::vec4 rows[4];
+    for (int row = 0; row < 4; ++row) {
+        rows[row] = glm::vec4(viewProjection[0][row], viewProjection[1][row], viewProjection[2][row], viewProjection[3][row]);
+    }
+
+    planes[0] = rows[3] + rows[0];
+    planes[1] = rows[3] - rows[0];
+    planes[2] = rows[3] + rows[1];
+    planes[3] = rows[3] - rows[1];
+    planes[4] = rows[3] + rows[2];
+    planes[5] = rows[3] - rows[2];
+
+    for (glm::vec4& plane : planes) {
+        float length = glm::length(glm::vec3(plane));
+        if (length > 0.0f) plane /= length;
+    }
+}
+
+Frustum::Result Frustum::classify(const glm::vec3& min, const glm::vec3& max) const {
+    glm::vec3 center = (min + max) * 0.5f;
+    glm::vec3 extent = (max - min) * 0.5f;
+
+    Result result = INSIDE;
+    for (const glm::vec4& plane : planes) {
+        float distance = glm::dot(glm::vec3(plane), center) + plane.w;
+        float radius = glm::dot(glm::abs(glm::vec3(plane)), extent);
+        if (distance < -radius) return OUTSIDE;
+        if (distance < radius) result = INTERSECTS;
+    }
+    return result;
+}
+
+// Planes in the outer loop and branch free selects in the inner one, so the inner loop vectorizes
+void Frustum::classify(const AABBArray& boxes, std::vector<uint8_t>& results) const {
+    const size_t count = boxes.size();
+    results.assign(count, INSIDE);
+
+    const float* cx = boxes.centerX.data();
+    const float* cy = boxes.centerY.data();
+    const float* cz = boxes.centerZ.data();
+    const float* ex = boxes.extentX.data();
+    const float* ey = boxes.extentY.data();
+    const float* ez = boxes.extentZ.data();
+    uint8_t* out = results.data();
+
+    for (const glm::vec4& plane : planes) {
+        const float nx = plane.x, ny = plane.y, nz = plane.z, d = plane.w;
+        const float ax = std::fabs(nx), ay = std::fabs(ny), az = std::fabs(nz);
+
+        for (size_t i = 0; i < count; ++i) {
+            float distance = nx * cx[i] + ny * cy[i] + nz * cz[i] + d;
+            float radius = ax * ex[i] + ay * ey[i] + az * ez[i];
+            uint8_t state = static_cast<uint8_t>((distance >= -radius) + (distance >= radius));
+            out[i] = std::min(out[i], state);
+        }
+    }
+}
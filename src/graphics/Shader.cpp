@@ -5,6 +5,20 @@ Shader::Shader(const std::string& vertexShaderPath, const std::string& fragmentS
 
     if (shaderID != -1) {
         this->ID = shaderID;
+        cacheUniformLocations();
+    } else {
+        std::cerr << "Shader creation failed, shader ID set to 0." << std::endl;
+        this->ID = 0;
+    }
+}
+
+Shader::Shader(const std::string& vertexShaderPath, const std::string& fragmentShaderPath, const std::vector<std::string>& defines)
+    : defines(defines) {
+    int shaderID = genShaderProgram(vertexShaderPath.c_str(), fragmentShaderPath.c_str());
+
+    if (shaderID != -1) {
+        this->ID = shaderID;
+        cacheUniformLocations();
     } else {
         std::cerr << "Shader creation failed, shader ID set to 0." << std::endl;
         this->ID = 0;
@@ -15,62 +29,123 @@ Shader::Shader() : ID(0) {}
 
 Shader::~Shader() {}
 
+GLuint Shader::s_currentProgram = 0;
+
 void Shader::use() {
+    if (s_currentProgram == this->ID) return;
     glUseProgram(this->ID);
+    s_currentProgram = this->ID;
 }
 
 void Shader::deleteShader() {
+    if (s_currentProgram == this->ID) s_currentProgram = 0;
     glDeleteProgram(this->ID);
 }
 
+// Reads every active uniform once after linking. Arrays are reported as name[0] and stored under both names
+void Shader::cacheUniformLocations() {
+    uniformLocations.clear();
+
+    GLint uniformCount = 0;
+    glGetProgramiv(this->ID, GL_ACTIVE_UNIFORMS, &uniformCount);
+    for (GLint i = 0; i < uniformCount; ++i) {
+        char name[256];
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(this->ID, static_cast<GLuint>(i), sizeof(name), &length, &size, &type, name);
+
+        std::string uniformName(name, length);
+        GLint location = glGetUniformLocation(this->ID, uniformName.c_str());
+        // Members of uniform blocks have no location and are set through the block's buffer
+        if (location < 0) continue;
+
+        uniformLocations[uniformName] = location;
+        if (uniformName.size() > 3 && uniformName.compare(uniformName.size() - 3, 3, "[0]") == 0) {
+            uniformLocations[uniformName.substr(0, uniformName.size() - 3)] = location;
+        }
+    }
+}
+
+GLint Shader::getUniformLocation(const std::string& name) const {
+    auto it = uniformLocations.find(name);
+    return it != uniformLocations.end() ? it->second : -1;
+}
+
+void Shader::bindUniformBlock(const char* blockName, GLuint binding) {
+    GLuint blockIndex = glGetUniformBlockIndex(this->ID, blockName);
+    if (blockIndex == GL_INVALID_INDEX) return;
+    glUniformBlockBinding(this->ID, blockIndex, binding);
+}
+
+void Shader::setMat4(GLint location, const glm::mat4& mat) {
+    use();
+    glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+}
+
+void Shader::setUniform3(GLint location, const glm::vec3& vec) {
+    use();
+    glUniform3fv(location, 1, glm::value_ptr(vec));
+}
+
+void Shader::setFloat(GLint location, float value) {
+    use();
+    glUniform1f(location, value);
+}
+
+void Shader::setInt(GLint location, int value) {
+    use();
+    glUniform1i(location, value);
+}
+
 void Shader::setMat4(const std::string& name, const glm::mat4& mat) {
     use();
-    glUniformMatrix4fv(glGetUniformLocation(this->ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
+    glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, glm::value_ptr(mat));
 }
 
 void Shader::setMat3(const std::string& name, const glm::mat3& mat) {
     use();
-    glUniformMatrix3fv(glGetUniformLocation(this->ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
+    glUniformMatrix3fv(getUniformLocation(name), 1, GL_FALSE, glm::value_ptr(mat));
 }
 
 void Shader::setVec3(const std::string& name, const glm::vec3& vec) {
     use();
-    glUniform4fv(glGetUniformLocation(this->ID, name.c_str()), 1, glm::value_ptr(vec));
+    glUniform3fv(getUniformLocation(name), 1, glm::value_ptr(vec));
 }
 
 void Shader::setVec4(const std::string& name, const glm::vec4& vec) {
     use();
-    glUniform4fv(glGetUniformLocation(this->ID, name.c_str()), 1, glm::value_ptr(vec));
+    glUniform4fv(getUniformLocation(name), 1, glm::value_ptr(vec));
 }
 
 void Shader::setUniform3(const std::string& name, const glm::mat3& mat) {
     use();
-    glUniformMatrix3fv(glGetUniformLocation(this->ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
+    glUniformMatrix3fv(getUniformLocation(name), 1, GL_FALSE, glm::value_ptr(mat));
 }
 
 void Shader::setUniform4(const std::string& name, const glm::mat4& mat) {
     use();
-    glUniformMatrix4fv(glGetUniformLocation(this->ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
+    glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, glm::value_ptr(mat));
 }
 
 void Shader::setUniform3(const std::string& name, const glm::vec3& vec) {
     use();
-    glUniform3fv(glGetUniformLocation(this->ID, name.c_str()), 1, glm::value_ptr(vec));
+    glUniform3fv(getUniformLocation(name), 1, glm::value_ptr(vec));
 }
 
 void Shader::setUniform4(const std::string& name, const glm::vec4& vec) {
     use();
-    glUniform4fv(glGetUniformLocation(this->ID, name.c_str()), 1, glm::value_ptr(vec));
+    glUniform4fv(getUniformLocation(name), 1, glm::value_ptr(vec));
 }
 
 void Shader::setFloat(const std::string& name, float value) {
     use();
-    glUniform1f(glGetUniformLocation(this->ID, name.c_str()), value);
+    glUniform1f(getUniformLocation(name), value);
 }
 
 void Shader::setInt(const std::string& name, int value) {
     use();
-    glUniform1i(glGetUniformLocation(this->ID, name.c_str()), value);
+    glUniform1i(getUniformLocation(name), value);
 }
 
 std::string Shader::readFile(const char* filename) {
@@ -91,8 +166,28 @@ std::string Shader::readFile(const char* filename) {
     return ret;
 }
 
+// Inserts the variant defines right after the #version line, which has to stay first
+std::string Shader::injectDefines(const std::string& source) const {
+    if (defines.empty()) return source;
+
+    std::string defineBlock;
+    for (const auto& define : defines) {
+        defineBlock += "#define " + define + "\n";
+    }
+
+    size_t insertAt = 0;
+    if (source.compare(0, 8, "#version") == 0) {
+        size_t lineEnd = source.find('\n');
+        insertAt = lineEnd == std::string::npos ? source.size() : lineEnd + 1;
+    }
+
+    std::string result = source;
+    result.insert(insertAt, defineBlock);
+    return result;
+}
+
 GLuint Shader::genShader(const char* filepath, GLenum type) {
-    std::string shaderSrc = readFile(filepath);
+    std::string shaderSrc = injectDefines(readFile(filepath));
     if (shaderSrc.empty()) {
         std::cerr << "Failed to read " << (type == GL_VERTEX_SHADER ? "vertex" : "fragment") 
                   << " shader source." << std::endl;
@@ -28,6 +28,26 @@ Texture::Texture(const char* path, GLenum texType, GLuint texSlot, GLenum format
     
 }
 
+Texture::Texture(const unsigned char* layerData, int width, int height, int layers, GLuint texSlot)
+    : type(GL_TEXTURE_2D_ARRAY), pixelType(GL_UNSIGNED_BYTE), slot(texSlot), texUniform(0),
+      width(width), height(height), nrChannels(4), layers(layers) {
+
+    glGenTextures(1, &ID);
+    glActiveTexture(GL_TEXTURE0 + slot);
+    glBindTexture(type, ID);
+
+    // Pixels stay sharp up close, distant faces blend between mip levels instead of shimmering
+    glTexParameteri(type, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR);
+    glTexParameteri(type, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(type, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(type, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+    glTexImage3D(type, 0, GL_RGBA8, width, height, layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, layerData);
+    glGenerateMipmap(type);
+
+    glBindTexture(type, 0);
+}
+
 Texture::Texture() : ID(0), type(GL_TEXTURE_2D), slot(0), texUniform(0), width(0), height(0), nrChannels(0) {}
 
 Texture::~Texture() {}
@@ -45,8 +65,8 @@ void Texture::deleteTexture() {
     glDeleteTextures(1, &ID);
 }
 
-void Texture::setUniform(Shader shader, const char* name, GLuint unit) {
-    texUniform = glGetUniformLocation(shader.ID, name);
+void Texture::setUniform(Shader& shader, const char* name, GLuint unit) {
+    texUniform = shader.getUniformLocation(name);
     shader.use();
     glUniform1i(texUniform, unit);
 }
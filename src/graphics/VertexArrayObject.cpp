@@ -28,16 +28,45 @@ void VertexArrayObject::deleteBuffers() {
     glDeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
     glDeleteBuffers(1, &EBO);
+    VAO = VBO = EBO = 0;
+    vertexCapacity = 0;
+    elementCapacity = 0;
 }
 
-void VertexArrayObject::addVertexBuffer(std::vector<Vertex>& vertices, GLenum usage) {
+void VertexArrayObject::addVertexBuffer(std::vector<Vertex>& vertices, GLenum usage, size_t capacity) {
     glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), usage);
+    if (capacity > vertices.size()) {
+        glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(Vertex), nullptr, usage);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(Vertex), vertices.data());
+        vertexCapacity = capacity;
+    } else {
+        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), usage);
+        vertexCapacity = vertices.size();
+    }
 }
 
-void VertexArrayObject::addElementBuffer(std::vector<GLuint>& indices, GLenum usage) {
+void VertexArrayObject::addElementBuffer(std::vector<GLuint>& indices, GLenum usage, size_t capacity) {
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), usage);
+    if (capacity > indices.size()) {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, capacity * sizeof(GLuint), nullptr, usage);
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indices.size() * sizeof(GLuint), indices.data());
+        elementCapacity = capacity;
+    } else {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), usage);
+        elementCapacity = indices.size();
+    }
+}
+
+void VertexArrayObject::updateVertexBuffer(const std::vector<Vertex>& vertices, size_t first, size_t count) {
+    if (count == 0) return;
+    glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
+    glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(Vertex), count * sizeof(Vertex), vertices.data() + first);
+}
+
+void VertexArrayObject::updateElementBuffer(const std::vector<GLuint>& indices, size_t first, size_t count) {
+    if (count == 0) return;
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->EBO);
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, first * sizeof(GLuint), count * sizeof(GLuint), indices.data() + first);
 }
 
 void VertexArrayObject::addAttribute(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer) {
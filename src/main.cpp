@@ -43,12 +43,21 @@ bool waitForServerConnection(UDPSocket& socket, const Address& serverAddr, float
     return false;
 }
 
-int main() {
+int main(int argc, char** argv) {
 
     std::filesystem::path basePath = !DEV_MODE
         ? std::filesystem::current_path().parent_path()
         : std::filesystem::current_path().parent_path().parent_path();
 
+    // --benchmark [report.json] flies a fixed path offline in a hidden window and writes a JSON report.
+    // On a machine without a GPU it runs on Mesa llvmpipe, e.g. xvfb-run -a env LIBGL_ALWAYS_SOFTWARE=1 ./TerraLink --benchmark
+    std::string benchmarkReport;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) != "--benchmark") continue;
+        benchmarkReport = (i + 1 < argc && argv[i + 1][0] != '-') ? argv[++i] : (basePath / "benchmark.json").string();
+    }
+    const bool benchmarking = !benchmarkReport.empty();
+
     initGLFW(3, 3);
 
     if (!initSockets()) {
@@ -60,6 +69,11 @@ int main() {
     NetworkManager::setInstance(&networkManager);
 
     bool onlineMode = GameInit::parseNetworkSettings((basePath / "network.settings").string());
+    if (benchmarking) {
+        NetworkManager::setRole(NetworkRole::CLIENT);
+        NetworkManager::setOnlineMode(false);
+        onlineMode = false;
+    }
 
     if (NetworkManager::getRole() == NetworkRole::SERVER) {
         if (!NetworkManager::instance().isOnlineMode()) {
@@ -74,6 +88,7 @@ int main() {
     }
 
     GLFWwindow* window = nullptr;
+    if (benchmarking) glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
     if (!createWindow(window, "TerraLink", 800, 800, !DEV_MODE)) {
         glfwTerminate();
         shutdownSockets();
@@ -83,6 +98,7 @@ int main() {
     Game game(window, DEV_MODE);
     Game::setInstance(&game);
     game.setGameVersion(gameVersionMajor, gameVersionMinor, gameVersionPatch);
+    if (benchmarking) game.setBenchmark(std::make_unique<Benchmark>(benchmarkReport));
 
     if (!onlineMode) {
         shutdownSockets();
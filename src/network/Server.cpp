@@ -466,6 +466,15 @@ std::shared_ptr<Chunk> Server::deserializeChunk(const std::vector<uint8_t>& in)
     std::memcpy(chunk->mesh.indices.data(), in.data() + offset, indexCount * sizeof(GLuint));
     offset += indexCount * sizeof(GLuint);
 
+    if (offset + sizeof(int32_t) <= in.size()) {
+        int rangeCount = Serializer::readInt32(in, offset);
+        if (rangeCount == static_cast<int>(chunk->mesh.cellRanges.size()) && offset + rangeCount * sizeof(uint32_t) <= in.size()) {
+            std::memcpy(chunk->mesh.cellRanges.data(), in.data() + offset, rangeCount * sizeof(uint32_t));
+            offset += rangeCount * sizeof(uint32_t);
+            chunk->mesh.hasCellRanges = chunk->mesh.cellRanges[MESH_SLOT_COUNT] * 4 == static_cast<uint32_t>(vertCount);
+        }
+    }
+
     chunk->mesh.isEmpty = chunk->mesh.vertices.empty() && chunk->mesh.indices.empty();
     chunk->mesh.needsUpdate = false;
     chunk->mesh.isUploaded = false;
@@ -496,4 +505,11 @@ void Server::serializeChunk(const std::shared_ptr<Chunk>& chunk, std::vector<uin
     out.insert(out.end(),
         reinterpret_cast<const uint8_t*>(indices.data()),
         reinterpret_cast<const uint8_t*>(indices.data()) + indices.size() * sizeof(GLuint));
+
+    const auto& ranges = chunk->mesh.cellRanges;
+    int32_t rangeCount = chunk->mesh.hasCellRanges ? static_cast<int32_t>(ranges.size()) : 0;
+    Serializer::writeInt32(out, rangeCount);
+    out.insert(out.end(),
+        reinterpret_cast<const uint8_t*>(ranges.data()),
+        reinterpret_cast<const uint8_t*>(ranges.data()) + rangeCount * sizeof(uint32_t));
 }
@@ -0,0 +1,383 @@
+// Headless chunk meshing benchmark, runs Chunk::generateMesh over a fixed region without a window or GL context
+// Usage: MeshBench [basePath] [--seed N] [--radius N] [--center X Z] [--threads N] [--iterations N]
+
+#include <iostream>
+#include <iomanip>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <algorithm>
+#include <filesystem>
+#include <unordered_map>
+#include <map>
+
+#include "core/registers/BlockRegister.h"
+#include "core/world/BiomeNoise.h"
+#include "core/world/World.h"
+#include "core/world/ChunkMesher.h"
+#include "core/world/ChunkCuller.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+// Every heap allocation in the process is counted, so mesher allocations show up without instrumenting it
+static std::atomic<uint64_t> allocationCount{ 0 };
+
+void* operator new(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+
+struct BenchSettings {
+    std::string basePath;
+    int seed = 453235343;
+    int radius = 8;
+    // Chunk column the region is centered on
+    int centerX = 0;
+    int centerZ = 0;
+    int minY = 0;
+    int maxY = 7;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    int iterations = 5;
+};
+
+struct BenchResult {
+    double seconds = 0.0;
+    uint64_t quads = 0;
+    uint64_t meshBytes = 0;
+    uint64_t allocations = 0;
+};
+
+// Meshes every chunk once across threadCount threads, each chunk into fresh buffers like a first mesh in game
+static BenchResult runMesher(const std::vector<std::shared_ptr<Chunk>>& chunks,
+                             const std::vector<ChunkNeighborAccessor>& neighbors, int threadCount) {
+    std::atomic<size_t> nextChunk{ 0 };
+    std::atomic<uint64_t> quads{ 0 };
+    std::atomic<uint64_t> meshBytes{ 0 };
+
+    auto worker = [&]() {
+        uint64_t localQuads = 0;
+        uint64_t localBytes = 0;
+        for (size_t i = nextChunk++; i < chunks.size(); i = nextChunk++) {
+            std::vector<Vertex> vertices;
+            std::vector<GLuint> indices;
+            MeshCellRanges cellRanges;
+            chunks[i]->generateMesh(vertices, indices, neighbors[i], &cellRanges);
+
+            localQuads += cellRanges[MESH_SLOT_COUNT];
+            localBytes += vertices.size() * sizeof(Vertex) + indices.size() * sizeof(GLuint);
+        }
+        quads += localQuads;
+        meshBytes += localBytes;
+    };
+
+    // Threads are started before the clock and the counter, their own allocations are not the mesher's
+    std::vector<std::thread> threads;
+    std::atomic<bool> start{ false };
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&]() {
+            while (!start) std::this_thread::yield();
+            worker();
+        });
+    }
+
+    uint64_t allocationsBefore = allocationCount.load();
+    auto startTime = std::chrono::steady_clock::now();
+    start = true;
+    for (auto& thread : threads) thread.join();
+    auto endTime = std::chrono::steady_clock::now();
+
+    BenchResult result;
+    result.seconds = std::chrono::duration<double>(endTime - startTime).count();
+    result.quads = quads;
+    result.meshBytes = meshBytes;
+    result.allocations = allocationCount.load() - allocationsBefore;
+    return result;
+}
+
+// Runs the mesher several times and reports the median run, so one descheduled thread does not skew the numbers
+static void reportMesher(const std::string& label, const std::vector<std::shared_ptr<Chunk>>& chunks,
+                         const std::vector<ChunkNeighborAccessor>& neighbors, int threadCount, int iterations) {
+    std::vector<BenchResult> results;
+    for (int i = 0; i < iterations; ++i) {
+        results.push_back(runMesher(chunks, neighbors, threadCount));
+    }
+    std::sort(results.begin(), results.end(), [](const BenchResult& a, const BenchResult& b) { return a.seconds < b.seconds; });
+    const BenchResult& median = results[results.size() / 2];
+
+    const double chunkCount = static_cast<double>(chunks.size());
+    std::cout << std::fixed << std::setprecision(1)
+              << label << " (" << threadCount << " thread" << (threadCount == 1 ? "" : "s") << "): "
+              << chunkCount / median.seconds << " chunks/s, "
+              << median.quads / median.seconds / 1e6 << " M quads/s, "
+              << median.meshBytes / chunkCount / 1024.0 << " KB/chunk, "
+              << std::setprecision(2) << median.allocations / chunkCount << " allocs/chunk, "
+              << std::setprecision(3) << median.seconds * 1000.0 / chunkCount << " ms/chunk\n";
+}
+
+// Times the mesher on the chunks of each biome on their own, dense forests mesh far more plant and leaf
+// faces per chunk than open plains
+static void reportBiomeMeshing(const std::vector<std::shared_ptr<Chunk>>& chunks,
+                               const std::vector<ChunkNeighborAccessor>& neighbors, int iterations) {
+    std::map<int, std::pair<std::vector<std::shared_ptr<Chunk>>, std::vector<ChunkNeighborAccessor>>> biomes;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        const ChunkPosition pos = chunks[i]->getPosition();
+        const int biome = BiomeNoise::getBiomeBlend(pos.x * CHUNK_SIZE + CHUNK_SIZE / 2, pos.z * CHUNK_SIZE + CHUNK_SIZE / 2, 1).front().first;
+        biomes[biome].first.push_back(chunks[i]);
+        biomes[biome].second.push_back(neighbors[i]);
+    }
+
+    for (const auto& [biome, group] : biomes) {
+        reportMesher(std::string(BiomeRegistry::getBiome(biome).name) + " " + std::to_string(group.first.size()) + " chunks",
+                     group.first, group.second, 1, iterations);
+    }
+}
+
+// Culls the region from the surface at its center, looking along the four horizontal axes,
+// and reports what would be drawn with frustum culling alone and with occlusion culling on top
+static void reportCulling(const ChunkCuller::ChunkMap& region, const std::vector<std::shared_ptr<Chunk>>& chunks,
+                          const std::vector<ChunkNeighborAccessor>& neighbors, const BenchSettings& settings) {
+    ChunkRenderList renderList;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        chunks[i]->generateMesh(chunks[i]->mesh.vertices, chunks[i]->mesh.indices, neighbors[i]);
+        chunks[i]->mesh.isEmpty = chunks[i]->mesh.vertices.empty();
+        chunks[i]->mesh.isUploaded = true;
+        renderList.update(chunks[i]);
+    }
+
+    const float centerX = (settings.centerX + 0.5f) * CHUNK_SIZE;
+    const float centerZ = (settings.centerZ + 0.5f) * CHUNK_SIZE;
+    const glm::vec3 eye(centerX, BiomeNoise::generateBlendedHeight(static_cast<int>(centerX), static_cast<int>(centerZ)) + 2.6f, centerZ);
+    const glm::mat4 projection = glm::perspective(glm::radians(80.0f), 16.0f / 9.0f, 0.1f, (settings.radius + 1) * (float)CHUNK_SIZE * 1.5f);
+    const glm::vec3 directions[4] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+
+    for (bool occlusion : { false, true }) {
+        ChunkCuller culler;
+        culler.setOcclusionCulling(occlusion);
+        std::vector<const ChunkDrawRecord*> visible;
+
+        size_t drawn = 0;
+        size_t triangles = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (const glm::vec3& direction : directions) {
+            culler.cull(renderList, region, projection * glm::lookAt(eye, eye + direction, glm::vec3(0, 1, 0)), eye, visible);
+            drawn += visible.size();
+            for (const ChunkDrawRecord* record : visible) triangles += (record->opaqueCount + record->cutoutCount) / 3;
+        }
+        double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << (occlusion ? "Frustum + occlusion" : "Frustum only") << " (4 views): "
+                  << drawn / 4.0 << " chunks, " << std::setprecision(3) << triangles / 4.0 / 1e6 << " M tris, "
+                  << milliseconds / 4.0 << " ms/view\n";
+    }
+}
+
+// Compares loading the full square of columns around the player with the circle inside the fog end that the game
+// loads: columns per view distance, then the chunks, mesh memory and meshing time of the region both ways
+static void reportViewShape(const std::vector<std::shared_ptr<Chunk>>& chunks,
+                            const std::vector<ChunkNeighborAccessor>& neighbors, const BenchSettings& settings) {
+    for (int viewDistance : { 4, 8, 16, 20, 32 }) {
+        const int square = (2 * viewDistance + 1) * (2 * viewDistance + 1);
+        int circle = 0;
+        for (int dz = -viewDistance; dz <= viewDistance; ++dz) {
+            for (int dx = -viewDistance; dx <= viewDistance; ++dx) {
+                if (isColumnInViewRange(dx, dz, viewRadiusBlocks(viewDistance))) ++circle;
+            }
+        }
+        std::cout << std::fixed << std::setprecision(1) << "View distance " << viewDistance << ": "
+                  << circle << " of " << square << " columns, " << 100.0 * (square - circle) / square << "% left out\n";
+    }
+
+    std::vector<std::shared_ptr<Chunk>> circleChunks;
+    std::vector<ChunkNeighborAccessor> circleNeighbors;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        const ChunkPosition pos = chunks[i]->getPosition();
+        if (!isColumnInViewRange(pos.x - settings.centerX, pos.z - settings.centerZ, viewRadiusBlocks(settings.radius))) continue;
+        circleChunks.push_back(chunks[i]);
+        circleNeighbors.push_back(neighbors[i]);
+    }
+
+    // Fastest of the iterations, both shapes mesh the same chunks apart from the corners
+    auto fastest = [&](const std::vector<std::shared_ptr<Chunk>>& meshChunks, const std::vector<ChunkNeighborAccessor>& meshNeighbors) {
+        BenchResult best = runMesher(meshChunks, meshNeighbors, settings.threads);
+        for (int i = 1; i < settings.iterations; ++i) {
+            BenchResult result = runMesher(meshChunks, meshNeighbors, settings.threads);
+            if (result.seconds < best.seconds) best = result;
+        }
+        return best;
+    };
+    const BenchResult square = fastest(chunks, neighbors);
+    const BenchResult circle = fastest(circleChunks, circleNeighbors);
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "Region as a square: " << chunks.size() << " chunks, " << square.meshBytes / (1024.0 * 1024.0) << " MB meshes, "
+              << square.seconds * 1000.0 << " ms to mesh\n"
+              << "Region as a circle: " << circleChunks.size() << " chunks, " << circle.meshBytes / (1024.0 * 1024.0) << " MB meshes, "
+              << circle.seconds * 1000.0 << " ms to mesh (" << 100.0 * (1.0 - static_cast<double>(circle.meshBytes) / square.meshBytes)
+              << "% less memory, " << 100.0 * (1.0 - circle.seconds / square.seconds) << "% less time)\n";
+}
+
+// Meshes the region with plants copied into the chunk meshes and again with plants instanced, and reports
+// the vertices per chunk by biome, since plant density is what differs between them
+static void reportPlants(BlockRegister& blockRegister, const std::vector<std::shared_ptr<Chunk>>& chunks,
+                         const std::vector<ChunkNeighborAccessor>& neighbors) {
+    struct BiomeCounts {
+        size_t chunks = 0;
+        uint64_t meshedVertices = 0;
+        uint64_t instancedVertices = 0;
+        uint64_t plants = 0;
+    };
+    std::map<int, BiomeCounts> biomes;
+
+    for (bool instanced : { false, true }) {
+        blockRegister.setInstancedPlants(instanced);
+        blockRegister.buildMeshTable();
+
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            const ChunkPosition pos = chunks[i]->getPosition();
+            const int biome = BiomeNoise::getBiomeBlend(pos.x * CHUNK_SIZE + CHUNK_SIZE / 2, pos.z * CHUNK_SIZE + CHUNK_SIZE / 2, 1).front().first;
+            BiomeCounts& counts = biomes[biome];
+
+            std::vector<Vertex> vertices;
+            std::vector<GLuint> indices;
+            chunks[i]->generateMesh(vertices, indices, neighbors[i]);
+            if (!instanced) {
+                ++counts.chunks;
+                counts.meshedVertices += vertices.size();
+                continue;
+            }
+
+            std::vector<uint32_t> plants;
+            PlantInstanceCounts plantCounts;
+            chunks[i]->generatePlantInstances(plants, plantCounts);
+            counts.instancedVertices += vertices.size();
+            counts.plants += plants.size();
+        }
+    }
+    blockRegister.setInstancedPlants(false);
+    blockRegister.buildMeshTable();
+
+    for (const auto& [biome, counts] : biomes) {
+        const double chunkCount = static_cast<double>(counts.chunks);
+        std::cout << std::fixed << std::setprecision(1)
+                  << BiomeRegistry::getBiome(biome).name << " (" << counts.chunks << " chunks): "
+                  << counts.meshedVertices / chunkCount << " vertices/chunk meshed, "
+                  << counts.instancedVertices / chunkCount << " vertices + " << counts.plants / chunkCount << " plants/chunk instanced, "
+                  << counts.meshedVertices * sizeof(Vertex) / chunkCount / 1024.0 << " KB -> "
+                  << (counts.instancedVertices * sizeof(Vertex) + counts.plants * sizeof(uint32_t)) / chunkCount / 1024.0 << " KB\n";
+    }
+}
+
+static bool parseArguments(int argc, char** argv, BenchSettings& settings) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto nextInt = [&](int& out) {
+            if (i + 1 >= argc) return false;
+            out = std::atoi(argv[++i]);
+            return true;
+        };
+
+        if (arg == "--seed") {
+            if (!nextInt(settings.seed)) return false;
+        } else if (arg == "--radius") {
+            if (!nextInt(settings.radius)) return false;
+        } else if (arg == "--center") {
+            if (!nextInt(settings.centerX) || !nextInt(settings.centerZ)) return false;
+        } else if (arg == "--threads") {
+            if (!nextInt(settings.threads)) return false;
+        } else if (arg == "--iterations") {
+            if (!nextInt(settings.iterations)) return false;
+        } else if (arg.rfind("--", 0) == 0) {
+            return false;
+        } else {
+            settings.basePath = arg;
+        }
+    }
+
+    settings.radius = std::max(0, settings.radius);
+    settings.threads = std::max(1, settings.threads);
+    settings.iterations = std::max(1, settings.iterations);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    BenchSettings settings;
+    // Same layout as the game in dev mode, run from build/<config>
+    settings.basePath = std::filesystem::current_path().parent_path().parent_path().string();
+
+    if (!parseArguments(argc, argv, settings)) {
+        std::cerr << "Usage: MeshBench [basePath] [--seed N] [--radius N] [--center X Z] [--threads N] [--iterations N]" << std::endl;
+        return 1;
+    }
+
+    // Textures are not needed to mesh, so the table is built straight from the models without an atlas
+    BlockRegister blockRegister(settings.basePath);
+    BlockRegister::setInstance(&blockRegister);
+    blockRegister.buildMeshTable();
+    if (blockRegister.blocks.size() <= 1) {
+        std::cerr << "No blocks loaded from " << settings.basePath << std::endl;
+        return 1;
+    }
+
+    BiomeNoise::initializeNoiseGenerator(settings.seed);
+
+    std::unordered_map<ChunkPosition, std::shared_ptr<Chunk>> region;
+    auto terrainStart = std::chrono::steady_clock::now();
+    for (int y = settings.minY; y <= settings.maxY; ++y) {
+        for (int z = settings.centerZ - settings.radius; z <= settings.centerZ + settings.radius; ++z) {
+            for (int x = settings.centerX - settings.radius; x <= settings.centerX + settings.radius; ++x) {
+                std::shared_ptr<Chunk> chunk = std::make_shared<Chunk>();
+                chunk->setPosition({ x, y, z });
+                chunk->generateTerrain();
+                region[{ x, y, z }] = chunk;
+            }
+        }
+    }
+    double terrainSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - terrainStart).count();
+
+    // Chunks are meshed against their real neighbors, as the game does once the region is loaded
+    std::vector<std::shared_ptr<Chunk>> chunks;
+    std::vector<ChunkNeighborAccessor> neighbors;
+    for (const auto& [pos, chunk] : region) {
+        if (chunk->mesh.isEmpty) continue;
+
+        ChunkNeighborAccessor accessor;
+        for (int face = 0; face < 6; ++face) {
+            auto it = region.find({ pos.x + FACE_OFFSETS[face].x, pos.y + FACE_OFFSETS[face].y, pos.z + FACE_OFFSETS[face].z });
+            if (it == region.end()) continue;
+            accessor.neighbors[face] = it->second;
+            accessor.knownNeighbors |= 1 << face;
+        }
+        chunks.push_back(chunk);
+        neighbors.push_back(accessor);
+    }
+
+    std::cout << "Seed " << settings.seed << ", " << region.size() << " chunks generated in "
+              << std::fixed << std::setprecision(2) << terrainSeconds << " s, " << chunks.size() << " with terrain" << std::endl;
+    if (chunks.empty()) return 0;
+
+    // Warm up caches and the allocator before measuring
+    runMesher(chunks, neighbors, 1);
+
+    reportMesher("Single-threaded", chunks, neighbors, 1, settings.iterations);
+    if (settings.threads > 1) {
+        reportMesher("Multi-threaded", chunks, neighbors, settings.threads, settings.iterations);
+    }
+
+    reportBiomeMeshing(chunks, neighbors, settings.iterations);
+
+    // The quad count only depends on the seed and region, a change means the mesher output changed
+    BenchResult check = runMesher(chunks, neighbors, 1);
+    std::cout << "Total quads: " << check.quads << std::endl;
+
+    reportCulling(region, chunks, neighbors, settings);
+    reportViewShape(chunks, neighbors, settings);
+    reportPlants(blockRegister, chunks, neighbors);
+    return 0;
+}